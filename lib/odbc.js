@@ -252,6 +252,14 @@ function Database(options)
   if(!ENV) ENV = self.odbc;
   self.queue = new SimpleQueue();
   self.fetchMode = options.fetchMode || null;
+  self.rowsetSize = options.rowsetSize || null;
+  self.prefetch = options.prefetch || false;
+  self.maxBufferSize = options.maxBufferSize || null;
+  self.timestampAsNumber = options.timestampAsNumber || false;
+  self.trimChar = options.trimChar || false;
+  self.bigintMode = options.bigintMode || null;
+  self.decimalMode = options.decimalMode || null;
+  self.dedupeStrings = options.dedupeStrings || false;
   self.connected = false;
   self.connectTimeout = options.connectTimeout || null;
   self.systemNaming = options.systemNaming;
@@ -417,6 +425,7 @@ Database.prototype.closeSync = function ()
 Database.prototype.query = function (query, params, cb)
 {
   var self = this, deferred, sql, resultset = [], multipleResultSet = false;
+  var rowsetSize = (query && query.rowsetSize) || self.rowsetSize;
 
   exports.debug && console.log(getElapsedTime(), "odbc.js:query() => Entry");
   //support for promises
@@ -459,6 +468,38 @@ Database.prototype.query = function (query, params, cb)
         {
           result.fetchMode = self.fetchMode;
         }
+        if (rowsetSize)
+        {
+          result.rowsetSize = rowsetSize;
+        }
+        if (self.prefetch)
+        {
+          result.prefetch = true;
+        }
+        if (self.maxBufferSize)
+        {
+          result.maxBufferSize = self.maxBufferSize;
+        }
+        if (self.timestampAsNumber)
+        {
+          result.timestampAsNumber = true;
+        }
+        if (self.trimChar)
+        {
+          result.trimChar = true;
+        }
+        if (self.bigintMode)
+        {
+          result.bigintMode = self.bigintMode;
+        }
+        if (self.decimalMode)
+        {
+          result.decimalMode = self.decimalMode;
+        }
+        if (self.dedupeStrings)
+        {
+          result.dedupeStrings = true;
+        }
 
         result.fetchAll(function (err, data) {
           var moreResults = false, moreResultsError = null;
@@ -559,6 +600,7 @@ Database.prototype.query = function (query, params, cb)
 Database.prototype.queryResult = function (query, params, cb)
 {
   var self = this, sql;
+  var rowsetSize = (query && query.rowsetSize) || self.rowsetSize;
 
   if (typeof(params) === 'function')
   {
@@ -599,6 +641,11 @@ Database.prototype.queryResult = function (query, params, cb)
       else
         self.conn.query(sql, params, cbQuery);
     }
+    else if (typeof query === 'object')
+    {
+      // keeps the statement options, such as cursorType
+      self.conn.query(query, cbQuery);
+    }
     else
     {
       self.conn.query(sql, cbQuery);
@@ -616,6 +663,38 @@ Database.prototype.queryResult = function (query, params, cb)
       {
         result.fetchMode = self.fetchMode;
       }
+      if (rowsetSize)
+      {
+        result.rowsetSize = rowsetSize;
+      }
+      if (self.prefetch)
+      {
+        result.prefetch = true;
+      }
+      if (self.maxBufferSize)
+      {
+        result.maxBufferSize = self.maxBufferSize;
+      }
+      if (self.timestampAsNumber)
+      {
+        result.timestampAsNumber = true;
+      }
+      if (self.trimChar)
+      {
+        result.trimChar = true;
+      }
+      if (self.bigintMode)
+      {
+        result.bigintMode = self.bigintMode;
+      }
+      if (self.decimalMode)
+      {
+        result.decimalMode = self.decimalMode;
+      }
+      if (self.dedupeStrings)
+      {
+        result.dedupeStrings = true;
+      }
 
       cb && cb(err, result);
 
@@ -656,7 +735,7 @@ Database.prototype.queryResultSync = function (query, params)
       if(typeof query === 'object')
       {
         query.params = params;
-        self.conn.querySync(query);
+        result = self.conn.querySync(query);
       }
       else
         result = self.conn.querySync(sql, params);
@@ -667,6 +746,11 @@ Database.prototype.queryResultSync = function (query, params)
       return result;
     }
   }
+  else if (typeof query === 'object')
+  {
+    // keeps the statement options, such as cursorType
+    result = self.conn.querySync(query);
+  }
   else
   {
     result = self.conn.querySync(sql);
@@ -676,10 +760,157 @@ Database.prototype.queryResultSync = function (query, params)
   {
     result.fetchMode = self.fetchMode;
   }
+  if (self.maxBufferSize)
+  {
+    result.maxBufferSize = self.maxBufferSize;
+  }
+  if (self.timestampAsNumber)
+  {
+    result.timestampAsNumber = true;
+  }
+  if (self.trimChar)
+  {
+    result.trimChar = true;
+  }
+  if (self.bigintMode)
+  {
+    result.bigintMode = self.bigintMode;
+  }
+  if (self.decimalMode)
+  {
+    result.decimalMode = self.decimalMode;
+  }
+  if (self.dedupeStrings)
+  {
+    result.dedupeStrings = true;
+  }
 
   return result;
 }; // Database.queryResultSync
 
+Database.prototype.queryArrow = function (query, params, cb)
+{
+  var self = this;
+
+  if (typeof(params) === 'function')
+  {
+    cb = params;
+    params = null;
+  }
+
+  self.queryResult(query, params, function (err, result)
+  {
+    if (err)
+    {
+      return cb && cb(err, null);
+    }
+
+    result.fetchArrow(function (err, data)
+    {
+      result.closeSync();
+      cb && cb(err, data);
+    });
+  });
+}; // Database.queryArrow
+
+Database.prototype.exportQuery = function (query, params, options, cb)
+{
+  var self = this;
+
+  if (typeof(options) === 'function')
+  {
+    cb = options;
+    options = params;
+    params = null;
+  }
+
+  if (!options || (options.format !== 'csv' && options.format !== 'ndjson'))
+  {
+    return cb && cb({ message : "Export format must be 'csv' or 'ndjson'." }, 0);
+  }
+
+  if (typeof(options.fd) !== 'number' && typeof(options.path) !== 'string')
+  {
+    return cb && cb({ message : "Export needs an fd or a path." }, 0);
+  }
+
+  self.queryResult(query, params, function (err, result)
+  {
+    if (err)
+    {
+      return cb && cb(err, 0);
+    }
+
+    result.exportRows(options, function (err, count)
+    {
+      result.closeSync();
+      cb && cb(err, count);
+    });
+  });
+}; // Database.exportQuery
+
+// Prepares sql, executes it once for every row of rows with
+// stmt.executeBatch and closes the statement
+Database.prototype.executeBatch = function (sql, rows, options, cb)
+{
+  var self = this, deferred;
+
+  if (typeof options === 'function')
+  {
+    cb = options;
+    options = null;
+  }
+  if (!cb)
+  {
+    deferred = Q.defer();
+  }
+
+  function done(err, result)
+  {
+    if (!deferred)
+    {
+      cb(err, result);
+    }
+    else if (err)
+    {
+      deferred.reject(err);
+    }
+    else
+    {
+      deferred.resolve(result);
+    }
+  }
+
+  self.prepare(sql, function (err, stmt)
+  {
+    if (err)
+    {
+      return done(err);
+    }
+
+    stmt.executeBatch(rows, options, function (err, result)
+    {
+      stmt.closeSync();
+      done(err, result);
+    });
+  });
+  return deferred ? deferred.promise : null;
+}; // Database.executeBatch
+
+Database.prototype.executeBatchSync = function (sql, rows, options)
+{
+  var self = this, stmt = self.prepareSync(sql);
+
+  try
+  {
+    return stmt.executeBatchSync(rows, options);
+  }
+  finally
+  {
+    stmt.closeSync();
+  }
+};
+
 Database.prototype.querySync = function (query, params)
 {
   var self = this, result, sql, outparams = null;
@@ -778,7 +1009,8 @@ Database.prototype.querySync = function (query, params)
 Database.prototype.queryStream = function queryStream(sql, params) 
 {
   var self = this;
-  var stream = new Readable({ objectMode: true });
+  var highWaterMark = (sql && typeof sql === 'object' && sql.highWaterMark) || 16;
+  var stream = new Readable({ objectMode: true, highWaterMark: highWaterMark });
   var results;
   stream._read = function() 
   {
@@ -798,26 +1030,63 @@ Database.prototype.queryStream = function queryStream(sql, params)
       return self.fetchStreamingResults(results, stream);
     });
   };
+  stream._destroy = function (err, cb)
+  {
+    // a batch being fetched closes the result when it completes
+    if (results && !results._streamFetching && !results._streamClosed)
+    {
+      results._streamClosed = true;
+      results.closeSync();
+    }
+    cb(err);
+  };
   return stream;
 };
 
+// Most rows of one fetchMany(), MAX_ROWSET_SIZE of the native code
+var MAX_FETCH_MANY = 65535;
+
+// Fills the stream with batches of rows fetched by fetchMany(), sized to
+// what the stream buffer can take. Nothing is fetched until the stream asks
+// for more, so a slow consumer leaves the rest of the rows at the cursor.
 Database.prototype.fetchStreamingResults = function(results, stream) 
 {
   var self = this;
-  return results.fetch(function (err, data) 
+  var state = stream._readableState;
+  var count = Math.min(Math.max(state.highWaterMark - state.length, 1), MAX_FETCH_MANY);
+
+  if (results._streamFetching || results._streamClosed) return;
+  results._streamFetching = true;
+
+  return results.fetchMany(count, function (err, rows, exhausted) 
   {
+    results._streamFetching = false;
+
+    if (stream.destroyed && !results._streamClosed)
+    {
+      results._streamClosed = true;
+      return results.closeSync();
+    }
     if (err) 
     {
+      if (!results._streamClosed)
+      {
+        results._streamClosed = true;
+        results.closeSync();
+      }
       return process.nextTick(function () { stream.emit('error', err); });
     }
+    for (var i = 0; i < rows.length; i++)
+    {
+      stream.push(rows[i]);
+    }
     // when no more data returns, return push null to indicate the end of stream
-    if (!data) 
+    if (exhausted) 
     { 
+      results._streamClosed = true;
+      results.closeSync();
       stream.push(null);
     }
-    else {
-      stream.push(data);
-    }
   });
 };
 
@@ -1100,11 +1369,27 @@ Database.prototype.prepareSync = function (sql)
 
   stmt.queue = new SimpleQueue();
 
+  if (sql && typeof sql === 'object')
+  {
+    setStatementOptions(stmt, sql);
+    sql = sql.sql;
+  }
+
   stmt.prepareSync(sql);
 
   return stmt;
 };
 
+// Applies the options of prepare({ sql : ..., cursorType : ... }) before the
+// statement is prepared
+function setStatementOptions(stmt, options)
+{
+  if (options.cursorType)
+  {
+    stmt.cursorType = options.cursorType;
+  }
+}
+
 Database.prototype.setIsolationLevel = function(isolationLevel) 
 {
   var self = this;
@@ -1121,6 +1406,8 @@ odbc.ODBCStatement.prototype._executeNonQuerySync = odbc.ODBCStatement.prototype
 odbc.ODBCStatement.prototype._prepare = odbc.ODBCStatement.prototype.prepare;
 odbc.ODBCStatement.prototype._bind = odbc.ODBCStatement.prototype.bind;
 odbc.ODBCStatement.prototype._bindSync = odbc.ODBCStatement.prototype.bindSync;
+odbc.ODBCStatement.prototype._executeBatch = odbc.ODBCStatement.prototype.executeBatch;
+odbc.ODBCStatement.prototype._executeBatchSync = odbc.ODBCStatement.prototype.executeBatchSync;
 
 odbc.ODBCStatement.prototype.execute = function (params, cb)
 {
@@ -1493,12 +1780,231 @@ odbc.ODBCStatement.prototype.executeNonQuery = function (params, cb)
   return deferred ? deferred.promise : null;
 };
 
+// Rows per SQLExecute of executeBatch, unless options.batchSize says otherwise
+var EXECUTE_BATCH_SIZE = 1000;
+
+// The number of rows of executeBatch, given as rows or as { columns }
+function batchLength(rows)
+{
+  if (Array.isArray(rows))
+  {
+    return rows.length;
+  }
+
+  var column = rows.columns[0];
+
+  if (column && column.offsets)
+  {
+    return Math.max(column.offsets.length - 1, 0);
+  }
+  if (column && !Array.isArray(column) && !ArrayBuffer.isView(column))
+  {
+    column = column.values;
+  }
+  return column ? column.length : 0;
+}
+
+// The rows start to end of executeBatch. Typed arrays and nulls bitmaps are
+// sliced without a copy, which needs start to be a multiple of 8. Values
+// with offsets keep all their values and take the offsets of the rows.
+function sliceBatch(rows, start, end)
+{
+  if (Array.isArray(rows))
+  {
+    return rows.slice(start, end);
+  }
+  if (start === 0 && end >= batchLength(rows))
+  {
+    return rows;
+  }
+
+  function slice(values)
+  {
+    return ArrayBuffer.isView(values) ? values.subarray(start, end) : values.slice(start, end);
+  }
+
+  return {
+    columns : rows.columns.map(function (column) {
+      if (Array.isArray(column) || ArrayBuffer.isView(column))
+      {
+        return slice(column);
+      }
+      if (column.offsets)
+      {
+        return {
+          values : column.values,
+          offsets : column.offsets.subarray(start, end + 1),
+          nulls : column.nulls && column.nulls.subarray(start / 8, Math.ceil(end / 8)),
+          type : column.type
+        };
+      }
+      return {
+        values : slice(column.values),
+        nulls : column.nulls && column.nulls.subarray(start / 8, Math.ceil(end / 8))
+      };
+    })
+  };
+}
+
+// Rows per batch of executeBatch; a multiple of 8 for { columns }
+function getBatchSize(rows, options)
+{
+  var batchSize = (options && options.batchSize) || EXECUTE_BATCH_SIZE;
+
+  if (!Array.isArray(rows))
+  {
+    batchSize = Math.max(8, batchSize - batchSize % 8);
+  }
+  return batchSize;
+}
+
+// Adds the result of the batch of rows starting at start to total
+function addBatchResult(total, result, start)
+{
+  total.count += result.count;
+  total.processed += result.processed;
+  result.failed.forEach(function (row) {
+    total.failed.push(start + row);
+  });
+}
+
+// Executes the prepared statement once for every row of rows, an Array of
+// Arrays of parameter values or { columns } with the values of each
+// parameter, with the values bound as arrays so that a batch of rows takes
+// one round trip. A column is an Array, an Int32Array, Float64Array,
+// BigInt64Array or Uint8Array (BIT), or { values, nulls } with one of those,
+// or { values, offsets, nulls, type } with character or binary data, as the
+// columns of FETCH_COLUMNAR. Each batch copies the values of the typed
+// arrays before it runs, so the worker thread never reads memory that
+// JavaScript can change or detach; later batches read them when they start,
+// so they should still not change until the callback. executeBatchSync
+// binds them in place. Stops after the first batch with a failed row; the
+// result counts the rows of the batches executed so far.
+odbc.ODBCStatement.prototype.executeBatch = function (rows, options, cb)
+{
+  var self = this, deferred, batchSize
+    , total = { count : 0, processed : 0, failed : [] };
+
+  if (typeof options === 'function')
+  {
+    cb = options;
+    options = null;
+  }
+  if (!cb)
+  {
+    deferred = Q.defer();
+  }
+
+  self.queue = self.queue || new SimpleQueue();
+
+  self.queue.push(function (next) {
+    function done(err)
+    {
+      if (!deferred)
+      {
+        cb(err, total);
+      }
+      else if (err)
+      {
+        err.result = total;
+        deferred.reject(err);
+      }
+      else
+      {
+        deferred.resolve(total);
+      }
+      return next();
+    }
+
+    function executeFrom(start)
+    {
+      if (start >= length)
+      {
+        return done(null);
+      }
+
+      try
+      {
+        self._executeBatch(sliceBatch(rows, start, start + batchSize), function (err, result) {
+          addBatchResult(total, result, start);
+
+          if (err)
+          {
+            return done(err);
+          }
+          executeFrom(start + batchSize);
+        });
+      }
+      catch (err)
+      {
+        done(err);
+      }
+    }
+
+    if (!rows || (!Array.isArray(rows) && !Array.isArray(rows.columns)))
+    {
+      return done({ message : "executeBatch needs an Array of rows or { columns }." });
+    }
+
+    var length = batchLength(rows);
+
+    batchSize = getBatchSize(rows, options);
+    executeFrom(0);
+  });
+  return deferred ? deferred.promise : null;
+};
+
+odbc.ODBCStatement.prototype.executeBatchSync = function (rows, options)
+{
+  var self = this, batchSize, length
+    , total = { count : 0, processed : 0, failed : [] };
+
+  if (!rows || (!Array.isArray(rows) && !Array.isArray(rows.columns)))
+  {
+    throw ({ message : "executeBatch needs an Array of rows or { columns }." });
+  }
+  batchSize = getBatchSize(rows, options);
+  length = batchLength(rows);
+
+  for (var start = 0; start < length; start += batchSize)
+  {
+    try
+    {
+      addBatchResult(total, self._executeBatchSync(sliceBatch(rows, start, start + batchSize)), start);
+    }
+    catch (err)
+    {
+      if (err.result)
+      {
+        addBatchResult(total, err.result, start);
+        err.result = total;
+      }
+      throw err;
+    }
+  }
+  return total;
+};
+
 odbc.ODBCStatement.prototype.prepare = function (sql, cb) {
   var self = this;
 
   self.queue = self.queue || new SimpleQueue();
 
   self.queue.push(function (next) {
+    if (sql && typeof sql === 'object')
+    {
+      try
+      {
+        setStatementOptions(self, sql);
+      }
+      catch (err)
+      {
+        cb && cb(err);
+        return next();
+      }
+      sql = sql.sql;
+    }
+
     self._prepare(sql, function (err) {
       cb && cb(err);
 
@@ -1540,6 +2046,161 @@ odbc.ODBCStatement.prototype.bindSync = function (ary) {
     return self._bindSync(ary); 
 };
 
+//Proxy ODBCResult.fetch so that a streamed LOB column comes back as a stream
+odbc.ODBCResult.prototype._fetch = odbc.ODBCResult.prototype.fetch;
+
+// With option lobStream = true, a BYTE, TEXT, BLOB or CLOB value in the last
+// column of the row is returned as a Readable stream of Buffers which reads
+// the value in chunks. The stream has to be read before the next fetch.
+odbc.ODBCResult.prototype.fetch = function (options, cb)
+{
+  var self = this;
+
+  if (typeof options === 'function')
+  {
+    cb = options;
+    options = {};
+  }
+
+  // the statement can only move to the next row once the stream of the
+  // current one is done with it
+  if (self._lobStream)
+  {
+    return self._lobStream.close(function () {
+      self.fetch(options, cb);
+    });
+  }
+
+  return self._fetch(options || {}, function (err, row, lobColumn)
+  {
+    // lobColumn is the name or index of the streamed column, or false
+    if (!err && row && lobColumn !== false && lobColumn !== undefined)
+    {
+      if (row[lobColumn] !== null)
+      {
+        row[lobColumn] = createLobStream(self, row[lobColumn]);
+      }
+    }
+    cb(err, row);
+  });
+};
+
+// The other methods of ODBCResult that use the statement wait for the LOB
+// stream of the current row, if any, to be done with it. The sync ones can
+// not wait and throw while a chunk is being read.
+['fetchMany', 'fetchAll', 'fetchAbsolute', 'fetchRelative', 'fetchArrow', 'exportRows']
+  .forEach(function (name)
+{
+  var method = odbc.ODBCResult.prototype[name];
+
+  odbc.ODBCResult.prototype[name] = function ()
+  {
+    var self = this, args = arguments;
+
+    if (self._lobStream)
+    {
+      return self._lobStream.close(function () {
+        method.apply(self, args);
+      });
+    }
+    return method.apply(self, args);
+  };
+});
+
+['fetchSync', 'fetchAllSync', 'moreResultsSync', 'closeSync'].forEach(function (name)
+{
+  var method = odbc.ODBCResult.prototype[name];
+
+  odbc.ODBCResult.prototype[name] = function ()
+  {
+    if (this._lobStream && !this._lobStream.closeSync())
+    {
+      throw new Error("[node-informixdb] ODBCResult." + name + ": a LOB stream is still reading from the result.");
+    }
+    return method.apply(this, arguments);
+  };
+});
+
+function createLobStream(result, chunk)
+{
+  var stream = new Readable()
+    , reading = false
+    , ended = false
+    , onIdle = null
+    , lob = {};
+
+  function end()
+  {
+    ended = true;
+    if (result._lobStream === lob) result._lobStream = null;
+  }
+
+  // called by fetch before the statement moves to the next row
+  lob.close = function (cb)
+  {
+    if (reading)
+    {
+      onIdle = function () { lob.close(cb); };
+      return;
+    }
+    if (!ended)
+    {
+      end();
+      stream.destroy();
+    }
+    cb();
+  };
+
+  // the same without waiting; false while a chunk is being read
+  lob.closeSync = function ()
+  {
+    if (reading) return false;
+    lob.close(function () {});
+    return true;
+  };
+
+  stream._read = function ()
+  {
+    if (chunk)
+    {
+      var first = chunk;
+      chunk = null;
+      if (first.length) return stream.push(first);
+    }
+    if (ended) return;
+
+    reading = true;
+    result.readLob(function (err, data)
+    {
+      reading = false;
+      if (err)
+      {
+        end();
+        stream.destroy(err);
+      }
+      else if (!data)
+      {
+        end();
+        stream.push(null);
+      }
+      else
+      {
+        stream.push(data);
+      }
+
+      if (onIdle)
+      {
+        var fn = onIdle;
+        onIdle = null;
+        fn();
+      }
+    });
+  };
+
+  result._lobStream = lob;
+  return stream;
+}
+
 
 module.exports.Pool = Pool;
 
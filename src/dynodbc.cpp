@@ -160,7 +160,7 @@ BOOL DynLoadODBC( char* odbcModuleName )
   if (LOAD_ENTRY( hMod, SQLGetDiagRec     )  )
   if (LOAD_ENTRY( hMod, SQLGetDiagField   )  )
   if (LOAD_ENTRY( hMod, SQLFreeHandle     )  )
-  //Unused-> if (LOAD_ENTRY( hMod, SQLFetchScroll    )  )
+  if (LOAD_ENTRY( hMod, SQLFetchScroll    )  )
   if (LOAD_ENTRY( hMod, SQLColAttribute   )  )
   if (LOAD_ENTRY( hMod, SQLSetConnectAttr )  )
   if (LOAD_ENTRY( hMod, SQLDriverConnect  )  )
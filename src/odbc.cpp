@@ -18,11 +18,15 @@
 */
 
 #include <string.h>
+#include <float.h>
 #include <v8.h>
 #include <node.h>
 #include <node_version.h>
 #include <time.h>
 #include <uv.h>
+#include <atomic>
+#include <map>
+#include <string>
 
 #include "odbc.h"
 #include "odbc_connection.h"
@@ -43,6 +47,14 @@ uv_async_t ODBC::g_async;
 
 Nan::Persistent<Function> ODBC::constructor;
 
+// Row templates by the list of column names they were made for. V8 keeps
+// every template it has instantiated until the context goes away, so one is
+// made per distinct list and none after TEMPLATE_CACHE_SIZE lists.
+typedef std::map<std::string, Nan::Persistent<ObjectTemplate>*> TemplateCache;
+
+static TemplateCache g_rowTemplates;
+static TemplateCache g_lazyTemplates;
+
 void ODBC::Init(v8::Local<Object> exports) {
   DEBUG_PRINTF("ODBC::Init\n");
   Nan::HandleScope scope;
@@ -64,6 +76,17 @@ void ODBC::Init(v8::Local<Object> exports) {
   constructor_template->Set(Nan::New<String>("SQL_DESTROY").ToLocalChecked(), Nan::New<Number>(SQL_DESTROY), constant_attributes);
   constructor_template->Set(Nan::New<String>("FETCH_ARRAY").ToLocalChecked(), Nan::New<Number>(FETCH_ARRAY), constant_attributes);
   NODE_ODBC_DEFINE_CONSTANT(constructor_template, FETCH_OBJECT);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, FETCH_COLUMNAR);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, FETCH_LAZY);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, BIGINT_STRING);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, BIGINT_NUMBER);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, BIGINT_BIGINT);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, DECIMAL_STRING);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, DECIMAL_NUMBER);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, SQL_CURSOR_FORWARD_ONLY);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, SQL_CURSOR_KEYSET_DRIVEN);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, SQL_CURSOR_DYNAMIC);
+  NODE_ODBC_DEFINE_CONSTANT(constructor_template, SQL_CURSOR_STATIC);
   
   // Prototype Methods
   Nan::SetPrototypeMethod(constructor_template, "createConnection", CreateConnection);
@@ -251,8 +274,46 @@ NAN_METHOD(ODBC::CreateConnectionSync) {
   info.GetReturnValue().Set(js_result);
 }
 
+/*
+ * AppendColumnString
+ *
+ * Copies length bytes of value to the end of the block of a Column array,
+ * growing it as needed, and returns their offset in the block. Two NUL
+ * bytes terminate narrow and wide names alike; offsets are even so wide
+ * names stay aligned.
+ */
+
+static size_t AppendColumnString(char** block, size_t* size, size_t* used,
+                                 const void* value, size_t length) {
+  size_t offset = (*used + 1) & ~((size_t) 1);
+  size_t needed = offset + length + 2;
+  
+  if (needed > *size) {
+    size_t grown = (*size * 2 > needed) ? *size * 2 : needed;
+    char* moved = (char *) realloc(*block, grown);
+    
+    if (moved == NULL) {
+      return 0;
+    }
+    
+    *block = moved;
+    *size = grown;
+  }
+  
+  memcpy(*block + offset, value, length);
+  (*block)[offset + length] = '\0';
+  (*block)[offset + length + 1] = '\0';
+  *used = needed;
+  
+  return offset;
+}
+
 /*
  * GetColumns
+ *
+ * The Column array and the names it points to are one block sized from the
+ * actual name lengths, released with FreeColumns. Returns NULL when the
+ * result set has no columns.
  */
 
 Column* ODBC::GetColumns(SQLHSTMT hStmt, short* colCount) {
@@ -266,22 +327,37 @@ Column* ODBC::GetColumns(SQLHSTMT hStmt, short* colCount) {
   //get the number of columns in the result set
   ret = SQLNumResultCols(hStmt, colCount);
   
-  if (!SQL_SUCCEEDED(ret)) {
-    return new Column[0];
+  if (!SQL_SUCCEEDED(ret) || *colCount <= 0) {
+    *colCount = 0;
+    return NULL;
   }
   
-  Column *columns = new Column[*colCount];
+  //the names follow the array; until the block stops moving the name
+  //pointers hold their offsets in it
+  size_t used = *colCount * sizeof(Column);
+  size_t size = used + *colCount * 32;
+  char *block = (char *) malloc(size);
   char colname[MAX_FIELD_SIZE];
+  char coltype[MAX_FIELD_SIZE];
+  size_t nameOffset;
+  size_t typeOffset;
+  
+  if (block == NULL) {
+    *colCount = 0;
+    return NULL;
+  }
 
   for (int i = 0; i < *colCount; i++) {
+    Column column;
+    
     //save the index number of this column
-    columns[i].index = i + 1;
-    colname[0] = '\0';
+    column.index = i + 1;
     buflen = 0;
+    typebuflen = 0;
     
     //get the column name
     ret = SQLColAttribute( hStmt,
-                           columns[i].index,
+                           column.index,
 #ifdef STRICT_COLUMN_NAMES
                            SQL_DESC_NAME,
 #else
@@ -292,45 +368,70 @@ Column* ODBC::GetColumns(SQLHSTMT hStmt, short* colCount) {
                            &buflen,
                            NULL);
     
-    //store the len attribute
-    columns[i].len = buflen;
-    if(buflen> 0)
-    {
-        columns[i].name = new unsigned char[buflen+2];
-        memcpy(columns[i].name, colname, buflen);
-        columns[i].name[buflen] = '\0';
-        columns[i].name[buflen+1] = '\0';
+    //a truncated name keeps what fit, a missing one is empty
+    if (!SQL_SUCCEEDED(ret) || buflen < 0) {
+      buflen = 0;
     }
-    else  // wrk, need to be fixed at ODBC level
-    {
-        columns[i].name = new unsigned char[2];
-        columns[i].name[0] = '\0';
-        
+    else if (buflen > MAX_FIELD_SIZE - 2) {
+      buflen = MAX_FIELD_SIZE - 2;
     }
-    DEBUG_PRINTF("ODBC::GetColumns index = %i, buflen=%i\n", columns[i].index, buflen);
     
-    //get the column type and store it directly in column[i].type
+    //store the len attribute
+    column.len = buflen;
+    DEBUG_PRINTF("ODBC::GetColumns index = %i, buflen=%i\n", column.index, buflen);
+    
+    //get the column type and store it directly in column.type
     ret = SQLColAttribute( hStmt,
-                           columns[i].index,
+                           column.index,
                            SQL_DESC_CONCISE_TYPE,
                            NULL,
                            0,
                            NULL,
-                           &columns[i].type);
-						   
-	columns[i].type_name = new unsigned char[(MAX_FIELD_SIZE)];
-    
-    //set the first byte of type_name to \0 instead of memsetting the entire buffer
-    columns[i].type_name[0] = '\0';
-	
-	ret = SQLColAttribute( hStmt,
-                           columns[i].index,
+                           &column.type);
+    
+    ret = SQLColAttribute( hStmt,
+                           column.index,
                            SQL_DESC_TYPE_NAME,
-                           columns[i].type_name,
+                           coltype,
                            (SQLSMALLINT) (MAX_FIELD_SIZE),
                            &typebuflen,
                            NULL);
+    
+    if (!SQL_SUCCEEDED(ret) || typebuflen < 0) {
+      typebuflen = 0;
+    }
+    else if (typebuflen > MAX_FIELD_SIZE - 2) {
+      typebuflen = MAX_FIELD_SIZE - 2;
+    }
+    
+    nameOffset = AppendColumnString(&block, &size, &used, colname, buflen);
+    typeOffset = AppendColumnString(&block, &size, &used, coltype, typebuflen);
+    
+    if (nameOffset == 0 || typeOffset == 0) {
+      free(block);
+      *colCount = 0;
+      return NULL;
+    }
+    
+    column.name = (unsigned char *) nameOffset;
+    column.type_name = (unsigned char *) typeOffset;
+    ((Column *) block)[i] = column;
+  }
+  
+  //give back what the last growth did not use and point at the names
+  char *shrunk = (char *) realloc(block, used);
+  
+  if (shrunk != NULL) {
+    block = shrunk;
+  }
+  
+  Column *columns = (Column *) block;
+  
+  for (int i = 0; i < *colCount; i++) {
+    columns[i].name = (unsigned char *) block + (size_t) columns[i].name;
+    columns[i].type_name = (unsigned char *) block + (size_t) columns[i].type_name;
   }
+  
   return columns;
 }
 
@@ -339,14 +440,419 @@ Column* ODBC::GetColumns(SQLHSTMT hStmt, short* colCount) {
  */
 
 void ODBC::FreeColumns(Column* columns, short* colCount) {
-  for(int i = 0; i < *colCount; i++) {
-      delete [] columns[i].name;
-      delete [] columns[i].type_name;
+  free(columns);
+  
+  *colCount = 0;
+}
+
+/*
+ * GetColumnCache
+ *
+ * Reads the column metadata of the current result set into a new cache
+ * holding one reference for the caller.
+ */
+
+ColumnCache* ODBC::GetColumnCache(SQLHSTMT hStmt) {
+  ColumnCache* cache = new ColumnCache;
+  
+  cache->columns = GetColumns(hStmt, &cache->colCount);
+  cache->refs = 1;
+  
+  return cache;
+}
+
+/*
+ * ReleaseColumnCache
+ *
+ * Drops one reference to cache, freeing it with the last one.
+ */
+
+void ODBC::ReleaseColumnCache(ColumnCache* cache) {
+  if (cache == NULL || --cache->refs > 0) {
+    return;
   }
+  
+  FreeColumns(cache->columns, &cache->colCount);
+  delete cache;
+}
+
+/*
+ * GetColumnNames
+ *
+ * Creates an internalized key for each column once per result set so the
+ * rows built in FETCH_OBJECT mode share them instead of creating and hashing
+ * a new string for every value. Released with FreeColumnNames.
+ */
 
-  delete [] columns;
+Nan::Persistent<String>* ODBC::GetColumnNames(Column* columns, short colCount) {
+  Nan::HandleScope scope;
   
-  *colCount = 0;
+  Nan::Persistent<String>* names = new Nan::Persistent<String>[colCount];
+  
+  for (int i = 0; i < colCount; i++) {
+#ifdef UNICODE
+    names[i].Reset(v8::String::NewFromTwoByte(ISOLATE,
+                     (const uint16_t *) columns[i].name,
+                     v8::NewStringType::kInternalized).ToLocalChecked());
+#else
+    names[i].Reset(v8::String::NewFromUtf8(ISOLATE,
+                     (const char *) columns[i].name,
+                     v8::NewStringType::kInternalized).ToLocalChecked());
+#endif
+  }
+  
+  return names;
+}
+
+/*
+ * FreeColumnNames
+ */
+
+void ODBC::FreeColumnNames(Nan::Persistent<String>* names, short colCount) {
+  if (names == NULL) {
+    return;
+  }
+  
+  for (int i = 0; i < colCount; i++) {
+    names[i].Reset();
+  }
+  
+  delete [] names;
+}
+
+/*
+ * GetTemplateKey
+ *
+ * The key of a list of column names in a TemplateCache: every name as UTF-8
+ * after its length, so that no two lists have the same key.
+ */
+
+static std::string GetTemplateKey(Nan::Persistent<String>* names, short colCount) {
+  std::string key;
+  
+  for (int i = 0; i < colCount; i++) {
+    Nan::Utf8String name(Nan::New(names[i]));
+    
+    key += std::to_string(name.length());
+    key += ':';
+    key.append(*name, name.length());
+  }
+  
+  return key;
+}
+
+/*
+ * GetRowTemplate
+ *
+ * Returns a template that declares every column as a property, in column
+ * order, so each row of a result set is created with its final shape instead
+ * of growing one property at a time. When two columns have the same name the
+ * property is where the first one is, as for rows built without a template.
+ * The template is shared by every result set with the same names; it is
+ * empty once TEMPLATE_CACHE_SIZE lists have one, and the rows are then plain
+ * objects.
+ */
+
+Local<ObjectTemplate> ODBC::GetRowTemplate(Nan::Persistent<String>* names, short colCount) {
+  Nan::EscapableHandleScope scope;
+  
+  std::string key = GetTemplateKey(names, colCount);
+  TemplateCache::iterator cached = g_rowTemplates.find(key);
+  
+  if (cached != g_rowTemplates.end()) {
+    return scope.Escape(Nan::New(*cached->second));
+  }
+  
+  if (g_rowTemplates.size() >= TEMPLATE_CACHE_SIZE) {
+    return scope.Escape(Local<ObjectTemplate>());
+  }
+  
+  Local<ObjectTemplate> rowTemplate = Nan::New<ObjectTemplate>();
+  
+  for (int i = 0; i < colCount; i++) {
+    bool repeated = false;
+    
+    for (int j = 0; j < i && !repeated; j++) {
+      repeated = Nan::New(names[i])->StrictEquals(Nan::New(names[j]));
+    }
+    
+    if (!repeated) {
+      Nan::SetTemplate(rowTemplate, Nan::New(names[i]), Nan::Null());
+    }
+  }
+  
+  g_rowTemplates[key] = new Nan::Persistent<ObjectTemplate>(rowTemplate);
+  
+  return scope.Escape(rowTemplate);
+}
+
+/*
+ * GetLazyRowTemplate
+ *
+ * Returns the template of FETCH_LAZY rows: an accessor per column that reads
+ * its value from the rowset in internal field 0, at the row in internal
+ * field 1. When two columns have the same name the last one wins, as for
+ * FETCH_OBJECT rows. Cached like GetRowTemplate; when it is empty the rows
+ * are converted as FETCH_OBJECT rows.
+ */
+
+Local<ObjectTemplate> ODBC::GetLazyRowTemplate(Nan::Persistent<String>* names, short colCount) {
+  Nan::EscapableHandleScope scope;
+  
+  std::string key = GetTemplateKey(names, colCount);
+  TemplateCache::iterator cached = g_lazyTemplates.find(key);
+  
+  if (cached != g_lazyTemplates.end()) {
+    return scope.Escape(Nan::New(*cached->second));
+  }
+  
+  if (g_lazyTemplates.size() >= TEMPLATE_CACHE_SIZE) {
+    return scope.Escape(Local<ObjectTemplate>());
+  }
+  
+  Local<ObjectTemplate> rowTemplate = Nan::New<ObjectTemplate>();
+  rowTemplate->SetInternalFieldCount(2);
+  
+  for (int i = 0; i < colCount; i++) {
+    bool repeated = false;
+    
+    for (int j = i + 1; j < colCount && !repeated; j++) {
+      repeated = Nan::New(names[i])->StrictEquals(Nan::New(names[j]));
+    }
+    
+    if (!repeated) {
+      Nan::SetAccessor(rowTemplate, Nan::New(names[i]), LazyValueGetter, 0,
+                       Nan::New<Integer>(i), v8::DEFAULT, v8::ReadOnly);
+    }
+  }
+  
+  g_lazyTemplates[key] = new Nan::Persistent<ObjectTemplate>(rowTemplate);
+  
+  return scope.Escape(rowTemplate);
+}
+
+/*
+ * IsDictionaryColumn
+ *
+ * True for the CHAR and VARCHAR columns whose values go through the string
+ * dictionary of a result with dedupeStrings.
+ */
+
+static bool IsDictionaryColumn(Column column)
+{
+  switch ((int) column.type) {
+    case SQL_CHAR :
+    case SQL_VARCHAR :
+    case SQL_WCHAR :
+    case SQL_WVARCHAR :
+      return true;
+    default :
+      return false;
+  }
+}
+
+/*
+ * IsCharColumn
+ *
+ * True for the fixed width CHAR and NCHAR columns, whose values are padded
+ * with blanks and trimmed with VALUE_TRIM_CHAR.
+ */
+
+static bool IsCharColumn(Column column)
+{
+  return (int) column.type == SQL_CHAR || (int) column.type == SQL_WCHAR;
+}
+
+/*
+ * TrimmedLength
+ *
+ * The length in bytes of the character data at value without its trailing
+ * blanks. The blanks are skipped eight bytes at a time, which is most of a
+ * padded CHAR value, then one character at a time.
+ */
+
+static SQLLEN TrimmedLength(const char* value, SQLLEN length)
+{
+#ifdef UNICODE
+  //four UTF-16 blanks read either way round
+  const uint64_t blanks = 0x0020002000200020ULL;
+  length &= ~1;
+#else
+  const uint64_t blanks = 0x2020202020202020ULL;
+#endif
+  
+  while (length >= 8) {
+    uint64_t word;
+    
+    memcpy(&word, value + length - 8, 8);
+    
+    if (word != blanks) {
+      break;
+    }
+    
+    length -= 8;
+  }
+  
+#ifdef UNICODE
+  while (length >= 2) {
+    uint16_t c;
+    
+    memcpy(&c, value + length - 2, 2);
+    
+    if (c != ' ') {
+      break;
+    }
+    
+    length -= 2;
+  }
+#else
+  while (length > 0 && value[length - 1] == ' ') {
+    length--;
+  }
+#endif
+  
+  return length;
+}
+
+/*
+ * AllocStringDictionary
+ *
+ * An empty dictionary, with no table yet. Released with FreeStringDictionary
+ * from the main thread.
+ */
+
+StringDictionary* ODBC::AllocStringDictionary()
+{
+  StringDictionary *dictionary = new StringDictionary;
+  
+  dictionary->tables = NULL;
+  dictionary->tableCount = 0;
+  
+  return dictionary;
+}
+
+/*
+ * FreeStringDictionary
+ */
+
+void ODBC::FreeStringDictionary(StringDictionary* dictionary)
+{
+  if (dictionary == NULL) {
+    return;
+  }
+  
+  for (int t = 0; t < dictionary->tableCount; t++) {
+    DictionaryEntry *entries = dictionary->tables[t].entries;
+    
+    if (entries == NULL) {
+      continue;
+    }
+    
+    for (int i = 0; i < DICTIONARY_SIZE; i++) {
+      entries[i].value.Reset();
+    }
+    
+    delete [] entries;
+  }
+  
+  delete [] dictionary->tables;
+  delete dictionary;
+}
+
+/*
+ * GetDictionaryTable
+ *
+ * The table of column number column, allocated when it has none yet.
+ */
+
+static DictionaryTable* GetDictionaryTable(StringDictionary* dictionary, SQLUSMALLINT column)
+{
+  if (column >= dictionary->tableCount) {
+    DictionaryTable *tables = new DictionaryTable[column + 1];
+    
+    for (int t = 0; t <= column; t++) {
+      tables[t].entries = (t < dictionary->tableCount) ? dictionary->tables[t].entries : NULL;
+      tables[t].count = (t < dictionary->tableCount) ? dictionary->tables[t].count : 0;
+    }
+    
+    delete [] dictionary->tables;
+    dictionary->tables = tables;
+    dictionary->tableCount = column + 1;
+  }
+  
+  DictionaryTable *table = &dictionary->tables[column];
+  
+  if (table->entries == NULL) {
+    table->entries = new DictionaryEntry[DICTIONARY_SIZE];
+    
+    for (int i = 0; i < DICTIONARY_SIZE; i++) {
+      table->entries[i].length = -1;
+    }
+  }
+  
+  return table;
+}
+
+/*
+ * GetDictionaryString
+ *
+ * The string of the length bytes of character data at value, taken from the
+ * table of column number column when the same bytes were converted before.
+ * New values of up to DICTIONARY_KEY_SIZE bytes are added until half of the
+ * slots of the table are used; longer values and the values after that are
+ * converted every time.
+ */
+
+Local<String> ODBC::GetDictionaryString(StringDictionary* dictionary, SQLUSMALLINT column,
+                                        const char* value, SQLLEN length)
+{
+  Nan::EscapableHandleScope scope;
+  
+  if (length > DICTIONARY_KEY_SIZE) {
+#ifdef UNICODE
+    return scope.Escape(Nan::New((const uint16_t *) value, (int) (length / 2)).ToLocalChecked());
+#else
+    return scope.Escape(Nan::New(value, (int) length).ToLocalChecked());
+#endif
+  }
+  
+  DictionaryTable *table = GetDictionaryTable(dictionary, column);
+  
+  //FNV-1a
+  uint32_t hash = 2166136261u;
+  
+  for (SQLLEN i = 0; i < length; i++) {
+    hash = (hash ^ (unsigned char) value[i]) * 16777619u;
+  }
+  
+  int slot = hash & (DICTIONARY_SIZE - 1);
+  
+  while (table->entries[slot].length >= 0) {
+    DictionaryEntry *entry = &table->entries[slot];
+    
+    if (entry->length == length && memcmp(entry->key, value, length) == 0) {
+      return scope.Escape(Nan::New(entry->value));
+    }
+    
+    slot = (slot + 1) & (DICTIONARY_SIZE - 1);
+  }
+  
+#ifdef UNICODE
+  Local<String> str = Nan::New((const uint16_t *) value, (int) (length / 2)).ToLocalChecked();
+#else
+  Local<String> str = Nan::New(value, (int) length).ToLocalChecked();
+#endif
+  
+  if (table->count < DICTIONARY_SIZE / 2) {
+    DictionaryEntry *entry = &table->entries[slot];
+    
+    entry->length = length;
+    memcpy(entry->key, value, length);
+    entry->value.Reset(str);
+    table->count++;
+  }
+  
+  return scope.Escape(str);
 }
 
 /*
@@ -354,7 +860,8 @@ void ODBC::FreeColumns(Column* columns, short* colCount) {
  */
 
 Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column, 
-                                    uint16_t* buffer, int bufferLength) 
+                                    ScratchBuffer* scratch, int flags,
+                                    StringDictionary* dictionary) 
 {
   Nan::EscapableHandleScope scope;
   SQLLEN len = 0;
@@ -371,7 +878,37 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
   DEBUG_PRINTF("Column Type : %i\t%i\t%i\t%i\n",column.type, SQL_DATETIME, 
                 SQL_TIMESTAMP, SQL_TYPE_TIME);
   //reset the buffer
-  buffer[0] = '\0';
+  scratch->buffer[0] = '\0';
+
+  //DATETIME columns are returned as strings unless asked for as numbers
+  if ((int) column.type == SQL_TYPE_TIMESTAMP && (flags & VALUE_TIMESTAMP_NUMBER)) {
+    column.type = SQL_TIMESTAMP;
+  }
+
+  if ((int) column.type == SQL_BIGINT &&
+      (flags & (VALUE_BIGINT_NUMBER | VALUE_BIGINT_BIGINT))) {
+    SQLBIGINT value;
+
+    ret = SQLGetData(hStmt, column.index, SQL_C_SBIGINT, &value, sizeof(value), &len);
+
+    DEBUG_PRINTF("ODBC::GetColumnValue - BigInt: index=%i name=%s type=%i len=%i ret=%i\n", 
+                 column.index, column.name, column.type, len, ret);
+
+    if (!SQL_SUCCEEDED(ret)) {
+      Nan::ThrowError(ODBC::GetSQLError( SQL_HANDLE_STMT, hStmt, errmsg));
+      return scope.Escape(Nan::Undefined());
+    }
+    if ((int)len == SQL_NULL_DATA) {
+      return scope.Escape(Nan::Null());
+    }
+    return scope.Escape(GetBigIntValue(value, flags));
+  }
+
+  //DECIMAL values are converted to a double by the driver, not through text
+  if (((int) column.type == SQL_DECIMAL || (int) column.type == SQL_NUMERIC) &&
+      (flags & VALUE_DECIMAL_NUMBER)) {
+    column.type = SQL_DOUBLE;
+  }
 
   switch ((int) column.type) 
   {
@@ -437,17 +974,11 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
         SQL_TIMESTAMP_STRUCT odbcTime;
 
         #ifdef _WIN32
-        struct tm timeInfo = {};
         ret = SQLGetData(hStmt, column.index, SQL_C_CHAR, 
                          &odbcTime, sizeof(odbcTime), &len);
         #else
-          #ifdef _AIX
-          struct tm timeInfo = {0,0,0,0,0,0,0,0,0};
-          #else
-          struct tm timeInfo = {0,0,0,0,0,0,0,0,0,0,0};
-          #endif
-          ret = SQLGetData(hStmt, column.index, SQL_C_TYPE_TIMESTAMP, 
-                           &odbcTime, sizeof(odbcTime), &len);
+        ret = SQLGetData(hStmt, column.index, SQL_C_TYPE_TIMESTAMP, 
+                         &odbcTime, sizeof(odbcTime), &len);
         #endif
 
         DEBUG_PRINTF("ODBC::GetColumnValue - Unix Timestamp: index=%i name=%s "
@@ -457,26 +988,7 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
           return scope.Escape(Nan::Null());
         }
         else {
-          timeInfo.tm_year = odbcTime.year - 1900;
-          timeInfo.tm_mon = odbcTime.month - 1;
-          timeInfo.tm_mday = odbcTime.day;
-          timeInfo.tm_hour = odbcTime.hour;
-          timeInfo.tm_min = odbcTime.minute;
-          timeInfo.tm_sec = odbcTime.second;
-
-          //a negative value means that mktime() should use timezone information 
-          //and system databases to attempt to determine whether DST is in effect 
-          //at the specified time.
-          timeInfo.tm_isdst = -1;
-
-          #ifdef TIMEGM
-          return scope.Escape(Nan::New<Date>((double(timegm(&timeInfo)) * 1000) + 
-                      (odbcTime.fraction / 1000000)).ToLocalChecked());
-          #else
-          return scope.Escape(Nan::New<Date>((double(mktime(&timeInfo)) * 1000) + 
-                      (odbcTime.fraction / 1000000)).ToLocalChecked());
-
-          #endif
+          return scope.Escape(GetTimestampValue(odbcTime, flags));
         }
       } 
       break;
@@ -502,12 +1014,34 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
         }
       }
       break;
-	/*
-	case SQL_NUMERIC :
-    case SQL_DECIMAL :
-    case SQL_BIGINT :
-    case SQL_BLOB :
-    */
+    case SQL_LONGVARBINARY :
+      {
+        SQLLEN indicator = 0;
+        ColumnBuffer value = { SQL_C_BINARY, MAX_VALUE_SIZE, NULL, &indicator };
+
+        ret = FetchColumnData(hStmt, column, &value);
+
+        DEBUG_PRINTF("ODBC::GetColumnValue - Binary: index=%i name=%s type=%i len=%i ret=%i\n",
+                     column.index, column.name, column.type, indicator, ret);
+
+        if (!SQL_SUCCEEDED(ret)) {
+          free(value.buffer);
+          Nan::ThrowError(ODBC::GetSQLError( SQL_HANDLE_STMT, hStmt, errmsg));
+          return scope.Escape(Nan::Undefined());
+        }
+
+        Local<Value> binary = TakeBinaryValue(&value);
+        free(value.buffer);
+
+        return scope.Escape(binary);
+      }
+      break;
+	/*
+	case SQL_NUMERIC :
+    case SQL_DECIMAL :
+    case SQL_BIGINT :
+    case SQL_BLOB :
+    */
 	case SQL_TYPE_TIME:
 		DEBUG_PRINTF("SQL_TIME SELECTED\n");
     case SQL_NUMERIC :
@@ -520,8 +1054,7 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
         if((int) column.type == SQL_BIGINT)
           DEBUG_PRINTF("BIGINT DATA SELECTED\n");
     default :
-      uint16_t * tmp_out_ptr = NULL;
-      int newbufflen = 0;
+      SQLLEN received = 0;
       int secondGetData = 0;
       len = 0;
 	  
@@ -533,45 +1066,47 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
       ret = SQLGetData( hStmt,
                         column.index,
                         ctype,
-                        (char *) buffer,
-                        bufferLength + terCharLen,
+                        (char *) scratch->buffer,
+                        scratch->length + terCharLen,
                         &len);
 
       DEBUG_PRINTF("ODBC::GetColumnValue - String: index=%i name=%s type=%i len=%i "
                    "ret=%i bufferLength=%i\n", column.index, column.name, 
-                   column.type, len, ret, bufferLength);
-      newbufflen = len;
+                   column.type, len, ret, scratch->length);
 
-      if( ret == SQL_SUCCESS_WITH_INFO )
+      //long value: keep what we have and read the rest into a bigger buffer
+      while ( ret == SQL_SUCCESS_WITH_INFO && len != SQL_NULL_DATA &&
+              (len == SQL_NO_TOTAL || received + len > scratch->length) )
       {
-          newbufflen = len + bufferLength;
-          if(newbufflen + terCharLen > 0x3fffffff)
-              terCharLen = 0x3fffffff - terCharLen;
-          tmp_out_ptr = (uint16_t *)malloc( newbufflen + terCharLen);
-          if(tmp_out_ptr == NULL)
+          //len is what was available before the last call, which started
+          //at received
+          SQLLEN needed = (len == SQL_NO_TOTAL) ? (SQLLEN) scratch->length * 2
+                                                : received + len;
+          SQLLEN filled = scratch->length;
+          if (terCharLen > 0) {
+            filled -= scratch->length % terCharLen;
+          }
+
+          if (!GrowScratchBuffer(scratch, needed))
           {
             ret = -3;
             errmsg = (char*)"Failed to allocate memory buffer for column data.";
-            DEBUG_PRINTF("Failed to allocate memory buffer of size %d\n", newbufflen + terCharLen);
-          }
-          else
-          {
-            memcpy(tmp_out_ptr, (char *) buffer, bufferLength);
-            //free((uint8_t *)buffer);
-            buffer = tmp_out_ptr;
-            len = 0;
-            ret = SQLGetData( hStmt,
-                              column.index,
-                              ctype,
-                              (char *) buffer + bufferLength,
-                              newbufflen + terCharLen,
-                              &len);
-            DEBUG_PRINTF("ODBC::GetColumnValue - String: index=%i name=%s type=%i len=%i "
-                         "ret=%i bufferLength=%i\n", column.index, column.name, 
-                         column.type, len, ret, newbufflen);
-            newbufflen = len + bufferLength;
-            secondGetData = 1;
+            DEBUG_PRINTF("Failed to allocate memory buffer of size %d\n", needed + terCharLen);
+            break;
           }
+          received = filled;
+
+          len = 0;
+          ret = SQLGetData( hStmt,
+                            column.index,
+                            ctype,
+                            (char *) scratch->buffer + received,
+                            scratch->length - received + terCharLen,
+                            &len);
+          DEBUG_PRINTF("ODBC::GetColumnValue - String: index=%i name=%s type=%i len=%i "
+                       "ret=%i bufferLength=%i\n", column.index, column.name, 
+                       column.type, len, ret, scratch->length);
+          secondGetData = 1;
       }
 
       if((int)len == SQL_NULL_DATA) {
@@ -582,16 +1117,37 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
       else if (SQL_SUCCEEDED(ret) || secondGetData) 
       {
           if(ctype == SQL_C_BINARY)
-              str = Nan::NewOneByteString((uint8_t *) buffer, newbufflen).ToLocalChecked();
+              str = Nan::NewOneByteString((uint8_t *) scratch->buffer,
+                                          (int) (received + len)).ToLocalChecked();
           else {
+            SQLLEN length = received + len;
+            
+            //cut the trailing blanks off by moving the terminator
+            if ((flags & VALUE_TRIM_CHAR) && IsCharColumn(column)) {
+              length = TrimmedLength((const char *) scratch->buffer, length);
+              #ifdef UNICODE
+              scratch->buffer[length / 2] = 0;
+              #else
+              ((char *) scratch->buffer)[length] = '\0';
+              #endif
+            }
+            
+            if (dictionary != NULL && !secondGetData && IsDictionaryColumn(column)) {
+              str = GetDictionaryString(dictionary, column.index, (const char *) scratch->buffer, length);
+            }
+            else {
             #ifdef UNICODE
-            str = Nan::New((uint16_t *) buffer).ToLocalChecked();
+            str = Nan::New((uint16_t *) scratch->buffer).ToLocalChecked();
             #else
-            str = Nan::New((char *) buffer).ToLocalChecked();
+            str = Nan::New((char *) scratch->buffer).ToLocalChecked();
             #endif
+            }
+          }
+
+          //do not keep more than maxLength bytes for the next rows
+          if (scratch->length > scratch->maxLength) {
+            ShrinkScratchBuffer(scratch);
           }
-          if(tmp_out_ptr) free(tmp_out_ptr);
-          //return scope.Escape(Nan::CopyBuffer((char*)buffer, 39767).ToLocalChecked());
       }
       else 
       {
@@ -608,6 +1164,9 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
                   hStmt, (int) column.type, column.index);
           assert(ret != SQL_INVALID_HANDLE);
         }
+        if (scratch->length > scratch->maxLength) {
+          ShrinkScratchBuffer(scratch);
+        }
         Nan::ThrowError(ODBC::GetSQLError( SQL_HANDLE_STMT, hStmt, errmsg));
         return scope.Escape(Nan::Undefined());
         break;
@@ -617,465 +1176,3699 @@ Local<Value> ODBC::GetColumnValue( SQLHSTMT hStmt, Column column,
 }
 
 /*
- * GetOutputParameter
+ * AllocScratchBuffer
+ *
+ * Allocates the buffer GetColumnValue reads values into with room for length
+ * bytes plus a terminating character. Longer values grow it and it is kept
+ * at up to MAX_BUFFER_SIZE bytes, or scratch->maxLength once set.
  */
 
-Local<Value> ODBC::GetOutputParameter( Parameter prm ) 
+bool ODBC::AllocScratchBuffer(ScratchBuffer* scratch, int length)
 {
-  Nan::EscapableHandleScope scope;
-  Local<String> str;
+  scratch->buffer = (uint16_t *) malloc(length + 2);
+  scratch->length = scratch->buffer ? length : 0;
+  scratch->initialLength = length;
+  scratch->maxLength = MAX_BUFFER_SIZE;
 
-  DEBUG_PRINTF("SQL Type of parameter: %i\n",prm.type);
-  switch ((int) prm.type) 
-  {
-    case SQL_INTEGER : 
-    case SQL_SMALLINT :
-    case SQL_TINYINT : 
-    case SQL_NUMERIC :
-        if((int) prm.type == SQL_NUMERIC)
-          DEBUG_PRINTF("NUMERIC DATA SELECTED\n");
-    case SQL_BIGINT :
-        if((int) prm.type == SQL_BIGINT)
-          DEBUG_PRINTF("BIGINT DATA SELECTED\n");
-      {
-        if((int)prm.length == SQL_NULL_DATA)
-        {
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
-                       "c_type=%i type=%i buf_len=%i len=%i val=%i\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, prm.buffer);
-          return scope.Escape(Nan::Null());
-        }
-        else if((int)prm.length == sizeof(int)){
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
-                       "c_type=%i type=%i buf_len=%i len=%i intval=%i\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, *(int*)prm.buffer);
-          return scope.Escape(Nan::New<Number>(*(int*)prm.buffer));
-        }
-        else if((int)prm.length == sizeof(short)){
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
-                       "c_type=%i type=%i buf_len=%i len=%i shortval=%i\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, *(short*)prm.buffer);
-          return scope.Escape(Nan::New<Number>(*(short*)prm.buffer));
-        }
-        else if((int)prm.length == sizeof(long)){
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
-                       "c_type=%i type=%i buf_len=%i len=%i longval=%i\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, *(long*)prm.buffer);
-          return scope.Escape(Nan::New<Number>(*(long*)prm.buffer));
-        }
-        else {
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
-                       "c_type=%i type=%i buf_len=%i len=%i charval=%s\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, *(char*)prm.buffer);
-          return scope.Escape(Nan::New<Number>(*(char *)prm.buffer));
-        }
-      }
-      break;
+  return scratch->buffer != NULL;
+}
 
-    case SQL_DECIMAL :
-        if((int) prm.type == SQL_DECIMAL)
-          DEBUG_PRINTF("DECIMAL DATA SELECTED\n");
-    case SQL_FLOAT :
-    case SQL_REAL :
-    case SQL_DOUBLE : 
-      {
-        if((int)prm.length == SQL_NULL_DATA)
-        {
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Number: paramtype=%i c_type=%i "
-                       "type=%i buf_len=%i len=%i nullval=%f\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, prm.buffer);
-          return scope.Escape(Nan::Null());
-        }
-        else {
-          DEBUG_PRINTF("ODBC::GetOutputParameter - Number: paramtype=%i c_type=%i "
-                       "type=%i buf_len=%i len=%i floatval=%f\n", 
-                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                       prm.length, *(double*)prm.buffer);
-          return scope.Escape(Nan::New<Number>(*(double*)prm.buffer));
-        }
-      }
-      break;
+/*
+ * GrowScratchBuffer
+ *
+ * Doubles the scratch buffer until it can hold length bytes, keeping its
+ * contents. Returns false, leaving the buffer as it was, when the memory
+ * could not be allocated.
+ */
 
-    case SQL_BIT :
-      {
-        DEBUG_PRINTF("ODBC::GetOutputParameter - Bit: paramtype=%i c_type=%i type=%i buf_len=%i len=%i val=%f\n", 
-                     prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                     prm.length, prm.buffer);
-        if((int)prm.length == SQL_NULL_DATA) {
-            return scope.Escape(Nan::Null());
-        }
-        else {
-            return scope.Escape(Nan::New((*((char*)prm.buffer) == '0') ? false : true));
-        }
-      }
-      break;
-	/*
-    case SQL_BLOB :
-    case SQL_DATETIME :
-    case SQL_TIMESTAMP : 
-    */
-    case SQL_TYPE_TIME:
-		DEBUG_PRINTF("SQL_TIME SELECTED\n");
-    default :
-      DEBUG_PRINTF("ODBC::GetOutputParameter - String: paramtype=%i c_type=%i type=%i buf_len=%i len=%i val=%s\n", 
-                   prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
-                   prm.length, prm.buffer);
-      if((int)prm.length == SQL_NULL_DATA) {
-          return scope.Escape(Nan::Null());
-      }
-      if(prm.c_type == SQL_C_BINARY)
-          str = Nan::NewOneByteString((uint8_t *) prm.buffer, prm.length).ToLocalChecked();
-      else {
-        #ifdef UNICODE
-        str = Nan::New((uint16_t *) prm.buffer).ToLocalChecked();
-        #else
-        str = Nan::New((char *) prm.buffer).ToLocalChecked();
-        #endif
-      }
-      return scope.Escape(str);
+bool ODBC::GrowScratchBuffer(ScratchBuffer* scratch, SQLLEN length)
+{
+  SQLLEN newLength = scratch->length > 0 ? scratch->length : MAX_VALUE_SIZE;
+
+  if (length > MAX_GROWN_BUFFER_SIZE) {
+    return false;
   }
+
+  while (newLength < length) {
+    newLength *= 2;
+  }
+  if (newLength > MAX_GROWN_BUFFER_SIZE) {
+    newLength = MAX_GROWN_BUFFER_SIZE;
+  }
+
+  uint16_t *grown = (uint16_t *) realloc(scratch->buffer, newLength + 2);
+  if (!grown) {
+    return false;
+  }
+
+  DEBUG_PRINTF("ODBC::GrowScratchBuffer %i -> %i\n", scratch->length, (int) newLength);
+
+  scratch->buffer = grown;
+  scratch->length = (int) newLength;
+
+  return true;
 }
 
 /*
- * GetRecordTuple
+ * ShrinkScratchBuffer
+ *
+ * Gives a grown scratch buffer back its initial length.
  */
 
-Local<Object> ODBC::GetRecordTuple ( SQLHSTMT hStmt, Column* columns, 
-                                         short* colCount, uint16_t* buffer,
-                                         int bufferLength) {
+void ODBC::ShrinkScratchBuffer(ScratchBuffer* scratch)
+{
+  if (scratch->buffer == NULL || scratch->length <= scratch->initialLength) {
+    return;
+  }
+
+  uint16_t *shrunk = (uint16_t *) realloc(scratch->buffer, scratch->initialLength + 2);
+  if (shrunk) {
+    DEBUG_PRINTF("ODBC::ShrinkScratchBuffer %i -> %i\n", scratch->length, scratch->initialLength);
+    scratch->buffer = shrunk;
+    scratch->length = scratch->initialLength;
+  }
+}
+
+/*
+ * FreeScratchBuffer
+ */
+
+void ODBC::FreeScratchBuffer(ScratchBuffer* scratch)
+{
+  free(scratch->buffer);
+  scratch->buffer = NULL;
+  scratch->length = 0;
+}
+
+/*
+ * GetTimestampValue
+ *
+ * A Date, or with VALUE_TIMESTAMP_NUMBER in flags the milliseconds since the
+ * epoch as a plain Number.
+ */
+
+Local<Value> ODBC::GetTimestampValue(SQL_TIMESTAMP_STRUCT &odbcTime, int flags)
+{
   Nan::EscapableHandleScope scope;
 
-  Local<Object> tuple = Nan::New<Object>();
-        
-  for(int i = 0; i < *colCount; i++) {
-#ifdef UNICODE
-    Nan::Set(tuple, Nan::New((uint16_t *) columns[i].name).ToLocalChecked(),
-                GetColumnValue( hStmt, columns[i], buffer, bufferLength));
-#else
-    Nan::Set(tuple, Nan::New((const char *) columns[i].name).ToLocalChecked(),
-                GetColumnValue( hStmt, columns[i], buffer, bufferLength));
-#endif
+  if (flags & VALUE_TIMESTAMP_NUMBER) {
+    return scope.Escape(Nan::New<Number>(GetTimestampMs(odbcTime)));
   }
-  
-  return scope.Escape(tuple);
+
+  return scope.Escape(Nan::New<Date>(GetTimestampMs(odbcTime)).ToLocalChecked());
 }
 
 /*
- * GetRecordArray
+ * GetBigIntValue
+ *
+ * A BIGINT value as a string of digits, or with VALUE_BIGINT_NUMBER in flags
+ * as a Number (exact up to 2^53) and with VALUE_BIGINT_BIGINT as a BigInt.
  */
 
-Local<Value> ODBC::GetRecordArray ( SQLHSTMT hStmt, Column* columns, 
-                                         short* colCount, uint16_t* buffer,
-                                         int bufferLength) {
+Local<Value> ODBC::GetBigIntValue(SQLBIGINT value, int flags)
+{
   Nan::EscapableHandleScope scope;
-  
-  Local<Array> array = Nan::New<Array>();
-        
-  for(int i = 0; i < *colCount; i++) {
-    Nan::TryCatch try_catch;
-    Nan::Set(array, Nan::New(i),
-              GetColumnValue( hStmt, columns[i], buffer, bufferLength));
-    if (try_catch.HasCaught()) {
-        FatalException(try_catch);
-        break;
-    }
+
+  if (flags & VALUE_BIGINT_BIGINT) {
+    return scope.Escape(v8::BigInt::New(ISOLATECOMMA (int64_t) value));
   }
-  
-  return scope.Escape(array);
+
+  if (flags & VALUE_BIGINT_NUMBER) {
+    return scope.Escape(Nan::New<Number>((double) value));
+  }
+
+  char digits[24];
+  snprintf(digits, sizeof(digits), "%lld", (long long) value);
+  return scope.Escape(Nan::New(digits).ToLocalChecked());
 }
 
 /*
- * GetParametersFromArray
+ * DaysFromCivil
+ *
+ * Days between 1970-01-01 and a date of the proleptic Gregorian calendar.
  */
 
-Parameter* ODBC::GetParametersFromArray (Local<Array> values, int *paramCount) {
-  DEBUG_PRINTF("ODBC::GetParametersFromArray\n");
-  *paramCount = values->Length();
-  
-  Parameter* params = (Parameter *) malloc(*paramCount * sizeof(Parameter));
-  if( !params ) {
-      Nan::LowMemoryNotification();
-      Nan::ThrowError("Could not allocate enough memory for params in ODBC::GetParametersFromArray.");
-      return params;
+static int64_t DaysFromCivil(int64_t year, unsigned month, unsigned day)
+{
+  year -= (month <= 2);
+
+  int64_t era = (year >= 0 ? year : year - 399) / 400;
+  unsigned yearOfEra = (unsigned) (year - era * 400);
+  unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+  return era * 146097 + (int64_t) dayOfEra - 719468;
+}
+
+#ifndef TIMEGM
+/*
+ * GetUTCOffset
+ *
+ * Seconds to subtract from a local time, counted as if it was UTC, to get
+ * the UTC time. mktime() is only asked once per local hour: the offsets are
+ * kept in a small table indexed by the hour, with the hour and the offset
+ * packed in one 64 bit entry so it can be shared by the thread pool. In the
+ * rare zones whose offset changes at half past, times in the half hour of
+ * the change can be off by the difference.
+ */
+
+#define UTC_OFFSET_CACHE_SIZE 4096
+#define UTC_OFFSET_BIAS (1 << 19)
+#define UTC_OFFSET_HOUR_BIAS ((int64_t) 1 << 32)
+
+static std::atomic<int64_t> utcOffsetCache[UTC_OFFSET_CACHE_SIZE];
+
+static int64_t GetUTCOffset(int64_t localSeconds)
+{
+  int64_t hour = (localSeconds >= 0 ? localSeconds : localSeconds - 3599) / 3600;
+  int64_t key = hour + UTC_OFFSET_HOUR_BIAS;
+  std::atomic<int64_t> &slot = utcOffsetCache[key & (UTC_OFFSET_CACHE_SIZE - 1)];
+  int64_t entry = slot.load(std::memory_order_relaxed);
+
+  if (entry != 0 && (entry >> 20) == key) {
+    return (entry & ((1 << 20) - 1)) - UTC_OFFSET_BIAS;
   }
-  memset(params, '\0', *paramCount * sizeof(Parameter));
 
-  for (int i = 0; i < *paramCount; i++) {
-    Local<Value> value = Nan::Get(values, i).ToLocalChecked();
-    
-    params[i].paramtype     = SQL_PARAM_INPUT;
-    params[i].size          = 0;
-    params[i].length        = SQL_NULL_DATA;
-    params[i].buffer_length = 0;
-    params[i].decimals      = 0;
+  #ifdef _WIN32
+  struct tm timeInfo = {};
+  #elif defined(_AIX)
+  struct tm timeInfo = {0,0,0,0,0,0,0,0,0};
+  #else
+  struct tm timeInfo = {0,0,0,0,0,0,0,0,0,0,0};
+  #endif
 
-    DEBUG_PRINTF("ODBC::GetParametersFromArray - &param[%i].length = %p\n",
-                 i, &params[i].length);
+  int64_t days = (hour >= 0 ? hour : hour - 23) / 24;
+  int64_t z = days + 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  unsigned dayOfEra = (unsigned) (z - era * 146097);
+  unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  unsigned mp = (5 * dayOfYear + 2) / 153;
+  unsigned month = mp < 10 ? mp + 3 : mp - 9;
 
-    if (value->IsArray()) 
-    {
-      Local<Value> val;
-      Local<Array> paramArray = Local<Array>::Cast(value);
-      int arrlen = paramArray->Length();
-      if(arrlen < 4)
-      {
-          DEBUG_PRINTF("ODBC::GetParametersFromArray - arrlen = %i\n", arrlen);
-          Nan::ThrowError("Wrong param format!");
-          return params;
-      }
+  timeInfo.tm_year = (int) (yearOfEra + era * 400 + (month <= 2)) - 1900;
+  timeInfo.tm_mon = month - 1;
+  timeInfo.tm_mday = dayOfYear - (153 * mp + 2) / 5 + 1;
+  timeInfo.tm_hour = (int) (hour - days * 24);
+
+  //a negative value means that mktime() should use timezone information 
+  //and system databases to attempt to determine whether DST is in effect 
+  //at the specified time.
+  timeInfo.tm_isdst = -1;
+
+  time_t utc = mktime(&timeInfo);
+  int64_t offset = hour * 3600 - (int64_t) utc;
+
+  if (utc != (time_t) -1 && offset > -UTC_OFFSET_BIAS && offset < UTC_OFFSET_BIAS) {
+    slot.store((key << 20) | (offset + UTC_OFFSET_BIAS), std::memory_order_relaxed);
+  }
+
+  return offset;
+}
+#endif
+
+/*
+ * GetTimestampMs
+ *
+ * Milliseconds since the epoch for a fetched timestamp, worked out from the
+ * calendar date without mktime(). Does not touch V8 so it can be used from
+ * the thread pool.
+ */
+
+double ODBC::GetTimestampMs(SQL_TIMESTAMP_STRUCT &odbcTime)
+{
+  int64_t seconds = DaysFromCivil(odbcTime.year, odbcTime.month, odbcTime.day) * 86400
+                  + odbcTime.hour * 3600 + odbcTime.minute * 60 + odbcTime.second;
+
+  #ifndef TIMEGM
+  seconds -= GetUTCOffset(seconds);
+  #endif
+
+  return (double(seconds) * 1000) + (odbcTime.fraction / 1000000);
+}
+
+/*
+ * GetColumnCType
+ *
+ * The C type used to fetch a column, which decides how GetColumnBufferValue
+ * converts it. width is set to the size of fixed length types and to 0 for
+ * character and binary data. DECIMAL and DATETIME columns are read as text
+ * unless flags ask for them as numbers.
+ */
+
+SQLSMALLINT ODBC::GetColumnCType(Column column, SQLLEN* width, int flags)
+{
+  *width = 0;
+
+  switch ((int) column.type) {
+    case SQL_DECIMAL :
+    case SQL_NUMERIC :
+      if (flags & VALUE_DECIMAL_NUMBER) {
+        *width = sizeof(double);
+        return SQL_C_DOUBLE;
+      }
+      return SQL_C_TCHAR;
+    case SQL_TYPE_TIMESTAMP :
+      if (flags & VALUE_TIMESTAMP_NUMBER) {
+        *width = sizeof(SQL_TIMESTAMP_STRUCT);
+        return SQL_C_TYPE_TIMESTAMP;
+      }
+      return SQL_C_TCHAR;
+    case SQL_INTEGER :
+    case SQL_SMALLINT :
+    case SQL_TINYINT :
+      *width = sizeof(SQLINTEGER);
+      return SQL_C_SLONG;
+    case SQL_BIGINT :
+      *width = sizeof(SQLBIGINT);
+      return SQL_C_SBIGINT;
+    case SQL_FLOAT :
+    case SQL_REAL :
+    case SQL_DOUBLE :
+      *width = sizeof(double);
+      return SQL_C_DOUBLE;
+    case SQL_DATETIME :
+    case SQL_TIMESTAMP :
+      *width = sizeof(SQL_TIMESTAMP_STRUCT);
+      return SQL_C_TYPE_TIMESTAMP;
+    case SQL_BIT :
+      *width = 4;
+      return SQL_C_CHAR;
+    case SQL_LONGVARBINARY :
+      return SQL_C_BINARY;
+    default :
+      return SQL_C_TCHAR;
+  }
+}
+
+/*
+ * GetLobCType
+ *
+ * The C type used to stream a long column in chunks, or 0 if the column
+ * is not a BYTE, TEXT, BLOB or CLOB column.
+ */
+
+SQLSMALLINT ODBC::GetLobCType(Column column)
+{
+  switch ((int) column.type) {
+    case SQL_LONGVARBINARY :
+#ifdef SQL_INFX_UDT_BLOB
+    case SQL_INFX_UDT_BLOB :
+#endif
+      return SQL_C_BINARY;
+    case SQL_LONGVARCHAR :
+    case SQL_WLONGVARCHAR :
+#ifdef SQL_INFX_UDT_CLOB
+    case SQL_INFX_UDT_CLOB :
+#endif
+      return SQL_C_CHAR;
+    default :
+      return 0;
+  }
+}
+
+/*
+ * BindColumns
+ *
+ * Bind every column of the current result set to an array of rowsetSize
+ * values so that one SQLFetch returns a whole rowset. All the arrays live in
+ * one allocation which is released with FreeColumnBuffers. rowsetSize may be
+ * lowered to stay within MAX_ROWSET_BUFFER_SIZE. Returns NULL, with nothing
+ * bound, when a column is too wide or of a type that has to be read with
+ * SQLGetData.
+ *
+ * With sets > 1 the allocation holds that many rowsets, each one the same
+ * number of bytes after the previous, so that SQL_ATTR_ROW_BIND_OFFSET_PTR
+ * can direct a fetch to any of them. The buffers of set k are the colCount
+ * entries starting at k * colCount; only the first set is bound.
+ */
+
+ColumnBuffer* ODBC::BindColumns(SQLHSTMT hStmt, Column* columns, short colCount,
+                                SQLULEN* rowsetSize, int flags, int sets)
+{
+  DEBUG_PRINTF("ODBC::BindColumns colCount=%i rowsetSize=%i\n", colCount, *rowsetSize);
+  SQLRETURN ret;
+  SQLLEN rowWidth = 0;
+
+  if (colCount <= 0 || *rowsetSize < 2) {
+    return NULL;
+  }
+
+  SQLSMALLINT *ctypes = new SQLSMALLINT[colCount];
+  SQLLEN *widths = new SQLLEN[colCount];
+
+  for (int i = 0; i < colCount; i++) {
+    SQLLEN displaySize = 0;
+
+    ctypes[i] = GetColumnCType(columns[i], &widths[i], flags);
+
+    if (widths[i] == 0 && ctypes[i] == SQL_C_TCHAR &&
+        (int) columns[i].type != SQL_LONGVARCHAR &&
+        (int) columns[i].type != SQL_WLONGVARCHAR) {
+      ret = SQLColAttribute( hStmt,
+                             columns[i].index,
+                             SQL_DESC_DISPLAY_SIZE,
+                             NULL,
+                             0,
+                             NULL,
+                             &displaySize);
+
+      if (SQL_SUCCEEDED(ret) && displaySize > 0) {
+        widths[i] = (displaySize + 1) * MAX_CHAR_BYTES;
+      }
+    }
+
+    if (widths[i] <= 0 || widths[i] > MAX_BOUND_COLUMN_SIZE) {
+      DEBUG_PRINTF("ODBC::BindColumns - column %i can not be bound\n", columns[i].index);
+      delete [] ctypes;
+      delete [] widths;
+      return NULL;
+    }
+
+    //keep every array 8 byte aligned
+    widths[i] = (widths[i] + 7) & ~7;
+    rowWidth += widths[i] + sizeof(SQLLEN);
+  }
+
+  if (*rowsetSize > MAX_ROWSET_SIZE) {
+    *rowsetSize = MAX_ROWSET_SIZE;
+  }
+  if (*rowsetSize * rowWidth * sets > MAX_ROWSET_BUFFER_SIZE) {
+    *rowsetSize = MAX_ROWSET_BUFFER_SIZE / (rowWidth * sets);
+  }
+  if (*rowsetSize < 2) {
+    delete [] ctypes;
+    delete [] widths;
+    return NULL;
+  }
+
+  size_t header = (sets * colCount * sizeof(ColumnBuffer) + 7) & ~7;
+  size_t stride = *rowsetSize * rowWidth;
+  char *block = (char *) malloc(header + stride * sets);
+
+  if (!block) {
+    delete [] ctypes;
+    delete [] widths;
+    return NULL;
+  }
+
+  ColumnBuffer *buffers = (ColumnBuffer *) block;
+  char *next = block + header;
+
+  for (int i = 0; i < colCount; i++) {
+    buffers[i].c_type = ctypes[i];
+    buffers[i].width = widths[i];
+    buffers[i].buffer = next;
+    next += *rowsetSize * widths[i];
+    buffers[i].indicators = (SQLLEN *) next;
+    next += *rowsetSize * sizeof(SQLLEN);
+
+    for (int set = 1; set < sets; set++) {
+      ColumnBuffer *copy = &buffers[set * colCount + i];
+
+      copy->c_type = buffers[i].c_type;
+      copy->width = buffers[i].width;
+      copy->buffer = buffers[i].buffer + set * stride;
+      copy->indicators = (SQLLEN *) ((char *) buffers[i].indicators + set * stride);
+    }
+
+    ret = SQLBindCol( hStmt,
+                      columns[i].index,
+                      buffers[i].c_type,
+                      buffers[i].buffer,
+                      buffers[i].width,
+                      buffers[i].indicators);
+
+    if (!SQL_SUCCEEDED(ret)) {
+      DEBUG_PRINTF("ODBC::BindColumns - SQLBindCol failed for column %i\n", columns[i].index);
+      SQLFreeStmt(hStmt, SQL_UNBIND);
+      free(block);
+      buffers = NULL;
+      break;
+    }
+  }
+
+  delete [] ctypes;
+  delete [] widths;
+
+  return buffers;
+}
+
+/*
+ * FreeColumnBuffers
+ */
+
+void ODBC::FreeColumnBuffers(ColumnBuffer* buffers) {
+  free(buffers);
+}
+
+/*
+ * AllocRowBuffer
+ *
+ * One ColumnBuffer per column, each holding a single row, for FetchRowData.
+ * Character and binary buffers start at MAX_VALUE_SIZE bytes and grow as
+ * longer values are read.
+ */
+
+ColumnBuffer* ODBC::AllocRowBuffer(Column* columns, short colCount, int flags)
+{
+  DEBUG_PRINTF("ODBC::AllocRowBuffer colCount=%i\n", colCount);
+
+  size_t header = (colCount * sizeof(ColumnBuffer) + 7) & ~7;
+  char *block = (char *) calloc(1, header + colCount * sizeof(SQLLEN));
+
+  if (!block) {
+    return NULL;
+  }
+
+  ColumnBuffer *row = (ColumnBuffer *) block;
+  SQLLEN *indicators = (SQLLEN *) (block + header);
+
+  for (int i = 0; i < colCount; i++) {
+    row[i].c_type = GetColumnCType(columns[i], &row[i].width, flags);
+    if (row[i].width == 0) {
+      row[i].width = MAX_VALUE_SIZE;
+    }
+    row[i].indicators = &indicators[i];
+    row[i].buffer = (char *) malloc(row[i].width);
+
+    if (!row[i].buffer) {
+      FreeRowBuffer(row, i);
+      return NULL;
+    }
+  }
+
+  return row;
+}
+
+/*
+ * FreeRowBuffer
+ */
+
+void ODBC::FreeRowBuffer(ColumnBuffer* row, short colCount)
+{
+  if (row == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < colCount; i++) {
+    free(row[i].buffer);
+  }
+
+  free(row);
+}
+
+/*
+ * ShrinkRowBuffer
+ *
+ * Releases the character and binary buffers of the row buffer that a long
+ * value grew past maxLength bytes. FetchColumnData allocates them again with
+ * MAX_VALUE_SIZE bytes for the next row.
+ */
+
+void ODBC::ShrinkRowBuffer(ColumnBuffer* row, short colCount, int maxLength)
+{
+  if (row == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < colCount; i++) {
+    if (row[i].width > maxLength && row[i].width > MAX_VALUE_SIZE &&
+        (row[i].c_type == SQL_C_TCHAR || row[i].c_type == SQL_C_BINARY)) {
+      free(row[i].buffer);
+      row[i].buffer = NULL;
+      row[i].width = MAX_VALUE_SIZE;
+    }
+  }
+}
+
+/*
+ * FetchRowData
+ *
+ * Called from the thread pool after SQLFetch: reads every column of the
+ * current row with SQLGetData into the row buffer. No V8 objects are touched
+ * here, the values are converted later on the main thread by
+ * GetColumnBufferValue.
+ */
+
+SQLRETURN ODBC::FetchRowData(SQLHSTMT hStmt, Column* columns, short colCount,
+                             ColumnBuffer* row)
+{
+  SQLRETURN ret = SQL_SUCCESS;
+
+  for (int i = 0; i < colCount; i++) {
+    ret = FetchColumnData(hStmt, columns[i], &row[i]);
+
+    if (!SQL_SUCCEEDED(ret)) {
+      return ret;
+    }
+  }
+
+  return ret;
+}
+
+/*
+ * FetchColumnData
+ *
+ * Reads one column of the current row with SQLGetData, growing the buffer
+ * until the whole value fits. A buffer taken over by TakeBinaryValue is
+ * allocated again with the current width.
+ */
+
+SQLRETURN ODBC::FetchColumnData(SQLHSTMT hStmt, Column column, ColumnBuffer* data)
+{
+  SQLRETURN ret;
+  SQLLEN len = 0;
+  SQLLEN offset = 0;
+#ifdef UNICODE
+  SQLLEN terCharLen = (data->c_type == SQL_C_BINARY) ? 0 : 2;
+#else
+  SQLLEN terCharLen = (data->c_type == SQL_C_BINARY) ? 0 : 1;
+#endif
+
+  if (data->buffer == NULL) {
+    data->buffer = (char *) malloc(data->width);
+
+    if (!data->buffer) {
+      DEBUG_PRINTF("ODBC::FetchColumnData - Failed to allocate %i bytes\n", data->width);
+      return SQL_ERROR;
+    }
+  }
+
+  ret = SQLGetData( hStmt,
+                    column.index,
+                    data->c_type,
+                    data->buffer,
+                    data->width,
+                    &len);
+
+  //long value: keep what we have and read the rest into a bigger buffer
+  while (ret == SQL_SUCCESS_WITH_INFO && 
+         (data->c_type == SQL_C_TCHAR || data->c_type == SQL_C_BINARY) &&
+         (len == SQL_NO_TOTAL || len > data->width - offset - terCharLen)) {
+    SQLLEN newWidth;
+
+    //len is what was available before this call, which started at offset
+    newWidth = (len == SQL_NO_TOTAL) ? data->width * 2 : offset + len + terCharLen;
+    offset = data->width - terCharLen;
+
+    char *grown = (char *) realloc(data->buffer, newWidth);
+    if (!grown) {
+      DEBUG_PRINTF("ODBC::FetchColumnData - Failed to allocate %i bytes\n", newWidth);
+      return SQL_ERROR;
+    }
+    data->buffer = grown;
+    data->width = newWidth;
+
+    ret = SQLGetData( hStmt,
+                      column.index,
+                      data->c_type,
+                      data->buffer + offset,
+                      data->width - offset,
+                      &len);
+  }
+
+  DEBUG_PRINTF("ODBC::FetchColumnData - index=%i type=%i len=%i offset=%i ret=%i\n",
+               column.index, (int) column.type, len, offset, ret);
+
+  if (SQL_SUCCEEDED(ret)) {
+    data->indicators[0] = (len == SQL_NULL_DATA) ? len : offset + len;
+  }
+
+  return ret;
+}
+
+/*
+ * TakeBinaryValue
+ *
+ * Returns the binary value in a row buffer as a Buffer which takes over the
+ * memory of the row buffer, trimmed to the length of the value, so the bytes
+ * are never copied. The row buffer is left without memory until the next
+ * FetchColumnData.
+ */
+
+Local<Value> ODBC::TakeBinaryValue(ColumnBuffer* data)
+{
+  Nan::EscapableHandleScope scope;
+  SQLLEN len = data->indicators[0];
+  char *value = data->buffer;
+
+  if (len == SQL_NULL_DATA) {
+    return scope.Escape(Nan::Null());
+  }
+
+  if (len == SQL_NO_TOTAL || len > data->width) {
+    len = data->width;
+  }
+
+  //do not keep the unused end of a buffer grown for a bigger value alive
+  if (len < data->width) {
+    char *trimmed = (char *) realloc(value, len > 0 ? len : 1);
+
+    if (trimmed) {
+      value = trimmed;
+    }
+  }
+
+  //the next row starts again from the width binary columns are read with
+  data->buffer = NULL;
+  data->width = MAX_VALUE_SIZE;
+
+  return scope.Escape(NewExternalBuffer(value, len));
+}
+
+/*
+ * ParseTimestamp
+ *
+ * Reads a DATETIME value converted to text by the driver, in the
+ * "YYYY-MM-DD hh:mm:ss.fffff" form or a leading part of it. Returns false
+ * for anything else.
+ */
+
+template <typename T>
+static bool ParseTimestamp(const T* text, SQLLEN length, SQL_TIMESTAMP_STRUCT* odbcTime)
+{
+  static const char separators[] = "-- ::";
+  int fields[6] = {0, 0, 0, 0, 0, 0};
+  SQLLEN pos = 0;
+  int i;
+
+  for (i = 0; i < 6; i++) {
+    if (i > 0) {
+      if (pos == length) {
+        break;
+      }
+      if (text[pos++] != (T) separators[i - 1]) {
+        return false;
+      }
+    }
+
+    SQLLEN start = pos;
+    for (; pos < length && text[pos] >= '0' && text[pos] <= '9'; pos++) {
+      fields[i] = fields[i] * 10 + (text[pos] - '0');
+    }
+    if (pos == start || pos - start > (i == 0 ? 4 : 2)) {
+      return false;
+    }
+  }
+
+  SQLUINTEGER fraction = 0;
+  int digits = 0;
+
+  if (pos < length && text[pos] == '.') {
+    for (pos++; pos < length && text[pos] >= '0' && text[pos] <= '9'; pos++) {
+      if (digits < 9) {
+        fraction = fraction * 10 + (text[pos] - '0');
+        digits++;
+      }
+    }
+  }
+  if (i < 3 || pos != length || fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > 31) {
+    return false;
+  }
+  for (; digits < 9; digits++) {
+    fraction *= 10;
+  }
+
+  odbcTime->year = fields[0];
+  odbcTime->month = fields[1];
+  odbcTime->day = fields[2];
+  odbcTime->hour = fields[3];
+  odbcTime->minute = fields[4];
+  odbcTime->second = fields[5];
+  odbcTime->fraction = fraction;
+
+  return true;
+}
+
+/*
+ * GetColumnBufferValue
+ *
+ * Same conversions as GetColumnValue, but reads the value of one row of a
+ * bound rowset or of a row buffer filled by FetchRowData instead of calling
+ * SQLGetData.
+ */
+
+Local<Value> ODBC::GetColumnBufferValue(Column column, ColumnBuffer* buffer, SQLULEN row,
+                                        int flags, StringDictionary* dictionary)
+{
+  Nan::EscapableHandleScope scope;
+  SQLLEN len = buffer->indicators[row];
+  char *value = buffer->buffer + (row * buffer->width);
+#ifdef UNICODE
+  int terCharLen = 2;
+#else
+  int terCharLen = 1;
+#endif
+
+  if (len == SQL_NULL_DATA) {
+    return scope.Escape(Nan::Null());
+  }
+
+  switch (buffer->c_type)
+  {
+    case SQL_C_SLONG :
+      return scope.Escape(Nan::New<Number>(*(SQLINTEGER *) value));
+
+    case SQL_C_DOUBLE :
+      return scope.Escape(Nan::New<Number>(*(double *) value));
+
+    case SQL_C_SBIGINT :
+      return scope.Escape(GetBigIntValue(*(SQLBIGINT *) value, flags));
+
+    case SQL_C_TYPE_TIMESTAMP :
+      return scope.Escape(GetTimestampValue(*(SQL_TIMESTAMP_STRUCT *) value, flags));
+
+    case SQL_C_BINARY :
+      //binary columns are never bound, so this is always a row buffer
+      return scope.Escape(TakeBinaryValue(buffer));
+
+    default :
+      if ((int) column.type == SQL_BIT) {
+        return scope.Escape(Nan::New((*value == '0') ? false : true));
+      }
+
+      //the driver truncates values which do not fit in the bound width
+      if (len == SQL_NO_TOTAL || len > buffer->width - terCharLen) {
+        len = buffer->width - terCharLen;
+      }
+
+      if ((int) column.type == SQL_TYPE_TIMESTAMP && (flags & VALUE_TIMESTAMP_NUMBER)) {
+        SQL_TIMESTAMP_STRUCT odbcTime;
+#ifdef UNICODE
+        if (ParseTimestamp((uint16_t *) value, len / 2, &odbcTime)) {
+#else
+        if (ParseTimestamp(value, len, &odbcTime)) {
+#endif
+          return scope.Escape(GetTimestampValue(odbcTime, flags));
+        }
+      }
+
+      if ((flags & VALUE_TRIM_CHAR) && IsCharColumn(column)) {
+        len = TrimmedLength(value, len);
+      }
+
+      if (dictionary != NULL && IsDictionaryColumn(column)) {
+        return scope.Escape(GetDictionaryString(dictionary, column.index, value, len));
+      }
+#ifdef UNICODE
+      return scope.Escape(Nan::New((uint16_t *) value, (int) (len / 2)).ToLocalChecked());
+#else
+      return scope.Escape(Nan::New(value, (int) len).ToLocalChecked());
+#endif
+  }
+}
+
+/*
+ * AllocColumnVectors
+ *
+ * Empty vectors for a FETCH_COLUMNAR fetch, one per column. Timestamps are
+ * stored as milliseconds since the epoch, bits as one byte per row, and
+ * everything that has no fixed width as character or binary data. Released
+ * with FreeColumnVectors.
+ */
+
+ColumnVector* ODBC::AllocColumnVectors(Column* columns, short colCount, int flags)
+{
+  DEBUG_PRINTF("ODBC::AllocColumnVectors colCount=%i\n", colCount);
+
+  ColumnVector *vectors = (ColumnVector *) calloc(colCount > 0 ? colCount : 1, sizeof(ColumnVector));
+
+  if (!vectors) {
+    return NULL;
+  }
+
+  for (int i = 0; i < colCount; i++) {
+    SQLLEN width;
+    SQLSMALLINT c_type = GetColumnCType(columns[i], &width, flags);
+
+    switch (c_type) {
+      case SQL_C_SLONG :
+      case SQL_C_DOUBLE :
+      case SQL_C_SBIGINT :
+        vectors[i].c_type = c_type;
+        vectors[i].width = width;
+        break;
+
+      case SQL_C_TYPE_TIMESTAMP :
+        vectors[i].c_type = SQL_C_DOUBLE;
+        vectors[i].width = sizeof(double);
+        break;
+
+      default :
+        if ((int) columns[i].type == SQL_BIT) {
+          vectors[i].c_type = SQL_C_BIT;
+          vectors[i].width = 1;
+        }
+        else {
+          vectors[i].c_type = SQL_C_BINARY;
+          vectors[i].width = 0;
+        }
+    }
+
+    if (!ReserveColumnVector(&vectors[i], 0)) {
+      FreeColumnVectors(vectors, colCount);
+      return NULL;
+    }
+  }
+
+  return vectors;
+}
+
+/*
+ * ReserveColumnVector
+ *
+ * Makes room for one more row and for dataLength more bytes of character or
+ * binary data. Returns false when memory runs out or the vector would grow
+ * past MAX_COLUMN_VECTOR_SIZE bytes.
+ */
+
+bool ODBC::ReserveColumnVector(ColumnVector* vector, size_t dataLength)
+{
+  if (vector->rowCount == vector->rowCapacity) {
+    SQLULEN capacity = vector->rowCapacity
+      ? vector->rowCapacity * 2
+      : COLUMN_VECTOR_INITIAL_ROWS;
+    size_t valueBytes = vector->width
+      ? capacity * vector->width
+      : (capacity + 1) * sizeof(int32_t);
+
+    if (valueBytes > MAX_COLUMN_VECTOR_SIZE) {
+      return false;
+    }
+
+    uint8_t *nulls = (uint8_t *) realloc(vector->nulls, capacity / 8);
+
+    if (!nulls) {
+      return false;
+    }
+
+    memset(nulls + vector->rowCapacity / 8, 0, (capacity - vector->rowCapacity) / 8);
+    vector->nulls = nulls;
+
+    if (vector->width) {
+      char *values = (char *) realloc(vector->values, valueBytes);
+
+      if (!values) {
+        return false;
+      }
+
+      vector->values = values;
+    }
+    else {
+      int32_t *offsets = (int32_t *) realloc(vector->offsets, valueBytes);
+
+      if (!offsets) {
+        return false;
+      }
+
+      if (vector->rowCapacity == 0) {
+        offsets[0] = 0;
+      }
+
+      vector->offsets = offsets;
+    }
+
+    vector->rowCapacity = capacity;
+  }
+
+  if (vector->dataLength + dataLength > vector->dataCapacity) {
+    size_t needed = vector->dataLength + dataLength;
+    size_t capacity = vector->dataCapacity ? vector->dataCapacity : MAX_VALUE_SIZE;
+
+    while (capacity < needed) {
+      capacity *= 2;
+    }
+
+    if (capacity > MAX_COLUMN_VECTOR_SIZE) {
+      if (needed > MAX_COLUMN_VECTOR_SIZE) {
+        return false;
+      }
+
+      capacity = MAX_COLUMN_VECTOR_SIZE;
+    }
+
+    char *values = (char *) realloc(vector->values, capacity);
+
+    if (!values) {
+      return false;
+    }
+
+    vector->values = values;
+    vector->dataCapacity = capacity;
+  }
+
+  return true;
+}
+
+/*
+ * AppendColumnVectors
+ *
+ * Appends one row of buffers, either a bound rowset or a row read with
+ * FetchRowData, to the vectors. Does not touch V8 so it can run on the
+ * thread pool. Returns false when a vector can not grow, in which case the
+ * vectors must only be freed.
+ */
+
+bool ODBC::AppendColumnVectors(Column* columns, ColumnVector* vectors, short colCount,
+                               ColumnBuffer* buffers, SQLULEN row, int flags)
+{
+#ifdef UNICODE
+  int terCharLen = 2;
+#else
+  int terCharLen = 1;
+#endif
+
+  for (int i = 0; i < colCount; i++) {
+    ColumnVector *vector = &vectors[i];
+    ColumnBuffer *buffer = &buffers[i];
+    SQLLEN len = buffer->indicators[row];
+    char *value = buffer->buffer + (row * buffer->width);
+    SQLULEN n = vector->rowCount;
+    bool isNull = (len == SQL_NULL_DATA);
+
+    if (isNull) {
+      len = 0;
+    }
+    else if (vector->width == 0) {
+      //the driver truncates values which do not fit in the bound width
+      SQLLEN maxLen = (buffer->c_type == SQL_C_BINARY)
+        ? buffer->width
+        : buffer->width - terCharLen;
+
+      if (len == SQL_NO_TOTAL || len > maxLen) {
+        len = maxLen;
+      }
+
+      if ((flags & VALUE_TRIM_CHAR) && IsCharColumn(columns[i])) {
+        len = TrimmedLength(value, len);
+      }
+    }
+
+    if (!ReserveColumnVector(vector, vector->width ? 0 : len)) {
+      return false;
+    }
+
+    if (isNull) {
+      vector->nulls[n >> 3] |= (uint8_t) (1 << (n & 7));
+
+      if (vector->width) {
+        memset(vector->values + (n * vector->width), 0, vector->width);
+      }
+    }
+    else {
+      switch (buffer->c_type)
+      {
+        case SQL_C_SLONG :
+          ((int32_t *) vector->values)[n] = *(SQLINTEGER *) value;
+          break;
+
+        case SQL_C_DOUBLE :
+          ((double *) vector->values)[n] = *(double *) value;
+          break;
+
+        case SQL_C_SBIGINT :
+          ((int64_t *) vector->values)[n] = *(SQLBIGINT *) value;
+          break;
+
+        case SQL_C_TYPE_TIMESTAMP :
+          ((double *) vector->values)[n] = GetTimestampMs(*(SQL_TIMESTAMP_STRUCT *) value);
+          break;
+
+        default :
+          if (vector->c_type == SQL_C_BIT) {
+            vector->values[n] = (*value == '0') ? 0 : 1;
+          }
+          else {
+            memcpy(vector->values + vector->dataLength, value, len);
+            vector->dataLength += len;
+          }
+      }
+    }
+
+    if (vector->width == 0) {
+      vector->offsets[n + 1] = (int32_t) vector->dataLength;
+    }
+
+    vector->rowCount++;
+  }
+
+  return true;
+}
+
+/*
+ * FreeColumnVectors
+ */
+
+void ODBC::FreeColumnVectors(ColumnVector* vectors, short colCount)
+{
+  if (vectors == NULL) {
+    return;
+  }
+
+  for (int i = 0; i < colCount; i++) {
+    free(vectors[i].values);
+    free(vectors[i].offsets);
+    free(vectors[i].nulls);
+  }
+
+  free(vectors);
+}
+
+/*
+ * GetColumnVectorsArray
+ *
+ * The FETCH_COLUMNAR result: one object per column with its name, SQL type,
+ * rowCount, a nulls bitmap Buffer and its values. Numeric values come as an
+ * Int32Array, Float64Array or BigInt64Array and bits as a Uint8Array.
+ * Character and binary data come as a Buffer with an Int32Array of
+ * rowCount + 1 offsets into it. The memory of the vectors is handed to the
+ * returned Buffers without copying; the vectors are left empty.
+ */
+
+Local<Array> ODBC::GetColumnVectorsArray(Column* columns, ColumnVector* vectors, short colCount)
+{
+  Nan::EscapableHandleScope scope;
+
+  Local<Array> array = Nan::New<Array>();
+
+  for (int i = 0; i < colCount; i++) {
+    ColumnVector *vector = &vectors[i];
+    SQLULEN rowCount = vector->rowCount;
+    Local<Object> column = Nan::New<Object>();
+
+#ifdef UNICODE
+    Nan::Set(column, Nan::New("name").ToLocalChecked(),
+             Nan::New((uint16_t *) columns[i].name).ToLocalChecked());
+#else
+    Nan::Set(column, Nan::New("name").ToLocalChecked(),
+             Nan::New((const char *) columns[i].name).ToLocalChecked());
+#endif
+    Nan::Set(column, Nan::New("type").ToLocalChecked(), Nan::New<Number>((double) columns[i].type));
+    Nan::Set(column, Nan::New("rowCount").ToLocalChecked(), Nan::New<Number>((double) rowCount));
+
+    Nan::Set(column, Nan::New("nulls").ToLocalChecked(),
+             NewExternalBuffer((char *) vector->nulls, (rowCount + 7) / 8));
+    vector->nulls = NULL;
+
+    Local<Object> values = NewExternalBuffer(vector->values,
+      vector->width ? rowCount * vector->width : vector->dataLength);
+    vector->values = NULL;
+
+    if (vector->width == 0) {
+      Local<Object> offsets = NewExternalBuffer((char *) vector->offsets,
+                                                (rowCount + 1) * sizeof(int32_t));
+      vector->offsets = NULL;
+
+      Nan::Set(column, Nan::New("offsets").ToLocalChecked(),
+               v8::Int32Array::New(offsets.As<v8::Uint8Array>()->Buffer(),
+                                   offsets.As<v8::Uint8Array>()->ByteOffset(),
+                                   rowCount + 1));
+      Nan::Set(column, Nan::New("values").ToLocalChecked(), values);
+    }
+    else {
+      Local<v8::ArrayBuffer> arrayBuffer = values.As<v8::Uint8Array>()->Buffer();
+      size_t byteOffset = values.As<v8::Uint8Array>()->ByteOffset();
+      Local<Value> typedArray;
+
+      switch (vector->c_type)
+      {
+        case SQL_C_SLONG :
+          typedArray = v8::Int32Array::New(arrayBuffer, byteOffset, rowCount);
+          break;
+
+        case SQL_C_DOUBLE :
+          typedArray = v8::Float64Array::New(arrayBuffer, byteOffset, rowCount);
+          break;
+
+        case SQL_C_SBIGINT :
+          typedArray = v8::BigInt64Array::New(arrayBuffer, byteOffset, rowCount);
+          break;
+
+        default :
+          typedArray = v8::Uint8Array::New(arrayBuffer, byteOffset, rowCount);
+      }
+
+      Nan::Set(column, Nan::New("values").ToLocalChecked(), typedArray);
+    }
+
+    Nan::Set(array, Nan::New(i), column);
+  }
+
+  return scope.Escape(array);
+}
+
+#ifdef UNICODE
+/*
+ * Utf16ToUtf8
+ *
+ * Transcodes count UTF-16 code units to UTF-8, at most 3 bytes per unit,
+ * and returns the number of bytes written. Unpaired surrogates become
+ * U+FFFD.
+ */
+
+static size_t Utf16ToUtf8(const uint16_t* utf16, size_t count, char* utf8)
+{
+  size_t length = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t c = utf16[i];
+
+    if (c >= 0xD800 && c <= 0xDBFF && i + 1 < count && utf16[i + 1] >= 0xDC00 && utf16[i + 1] <= 0xDFFF) {
+      c = 0x10000 + ((c - 0xD800) << 10) + (utf16[++i] - 0xDC00);
+    }
+    else if (c >= 0xD800 && c <= 0xDFFF) {
+      c = 0xFFFD;
+    }
+
+    if (c < 0x80) {
+      utf8[length++] = (char) c;
+    }
+    else if (c < 0x800) {
+      utf8[length++] = (char) (0xC0 | (c >> 6));
+      utf8[length++] = (char) (0x80 | (c & 0x3F));
+    }
+    else if (c < 0x10000) {
+      utf8[length++] = (char) (0xE0 | (c >> 12));
+      utf8[length++] = (char) (0x80 | ((c >> 6) & 0x3F));
+      utf8[length++] = (char) (0x80 | (c & 0x3F));
+    }
+    else {
+      utf8[length++] = (char) (0xF0 | (c >> 18));
+      utf8[length++] = (char) (0x80 | ((c >> 12) & 0x3F));
+      utf8[length++] = (char) (0x80 | ((c >> 6) & 0x3F));
+      utf8[length++] = (char) (0x80 | (c & 0x3F));
+    }
+  }
+
+  return length;
+}
+#endif
+
+/*
+ * ArrowMetadata
+ *
+ * Just enough of a FlatBuffers builder for the Schema and RecordBatch
+ * messages of an Arrow IPC stream. Like the FlatBuffers library it builds
+ * back to front: children are written before the tables that point at them
+ * and offsets are counted from the end of the buffer.
+ */
+
+#define ARROW_MAX_TABLE_FIELDS 8
+
+class ArrowMetadata {
+  public:
+    ArrowMetadata() : buffer(NULL), capacity(0), head(0), minAlign(1), failed(false) {}
+    ~ArrowMetadata() { free(buffer); }
+    
+    size_t Size() { return capacity - head; }
+    const char* Data() { return buffer + head; }
+    bool Failed() { return failed; }
+    
+    //pads so that extra more bytes end on a multiple of alignment
+    void Align(size_t alignment, size_t extra = 0) {
+      if (alignment > minAlign) {
+        minAlign = alignment;
+      }
+      
+      size_t padding = (alignment - ((Size() + extra) % alignment)) % alignment;
+      
+      if (Reserve(padding)) {
+        head -= padding;
+        memset(buffer + head, 0, padding);
+      }
+    }
+    
+    void PushBytes(const void* data, size_t length) {
+      if (Reserve(length)) {
+        head -= length;
+        memcpy(buffer + head, data, length);
+      }
+    }
+    
+    template <typename T>
+    void Push(T value) {
+      Align(sizeof(T));
+      PushBytes(&value, sizeof(T));
+    }
+    
+    void PushOffset(uint32_t offset) {
+      Align(4);
+      Push<uint32_t>((uint32_t) (Size() + 4 - offset));
+    }
+    
+    uint32_t CreateString(const char* value, size_t length) {
+      Align(4, length + 1);
+      Push<uint8_t>(0);
+      PushBytes(value, length);
+      Push<uint32_t>((uint32_t) length);
+      
+      return (uint32_t) Size();
+    }
+    
+    //vectors of offsets are filled last element first
+    void StartVector(size_t count, size_t elementSize, size_t alignment) {
+      Align(4, count * elementSize);
+      Align(alignment, count * elementSize);
+    }
+    
+    uint32_t EndVector(size_t count) {
+      Push<uint32_t>((uint32_t) count);
+      
+      return (uint32_t) Size();
+    }
+    
+    void StartTable() {
+      memset(fields, 0, sizeof(fields));
+      fieldCount = 0;
+      tableStart = Size();
+    }
+    
+    template <typename T>
+    void AddField(int id, T value) {
+      Push<T>(value);
+      SetField(id);
+    }
+    
+    void AddOffset(int id, uint32_t offset) {
+      PushOffset(offset);
+      SetField(id);
+    }
+    
+    uint32_t EndTable() {
+      Push<int32_t>(0);
+      
+      size_t table = Size();
+      
+      for (int id = fieldCount - 1; id >= 0; id--) {
+        Push<uint16_t>((uint16_t) (fields[id] ? table - fields[id] : 0));
+      }
+      Push<uint16_t>((uint16_t) (table - tableStart));
+      Push<uint16_t>((uint16_t) ((fieldCount + 2) * sizeof(uint16_t)));
+      
+      //the table starts with the distance back to its vtable
+      if (!failed) {
+        int32_t vtable = (int32_t) (Size() - table);
+        memcpy(buffer + capacity - table, &vtable, sizeof(vtable));
+      }
+      
+      return (uint32_t) table;
+    }
+    
+    void Finish(uint32_t root) {
+      Align(minAlign > 8 ? minAlign : 8, 4);
+      PushOffset(root);
+    }
+    
+  private:
+    bool Reserve(size_t length) {
+      if (failed) {
+        return false;
+      }
+      
+      if (head < length) {
+        size_t size = Size();
+        size_t grown = capacity ? capacity * 2 : 1024;
+        
+        while (grown < size + length) {
+          grown *= 2;
+        }
+        
+        char *moved = (char *) malloc(grown);
+        
+        if (moved == NULL) {
+          failed = true;
+          return false;
+        }
+        
+        memcpy(moved + grown - size, buffer + head, size);
+        free(buffer);
+        
+        buffer = moved;
+        head = grown - size;
+        capacity = grown;
+      }
+      
+      return true;
+    }
+    
+    void SetField(int id) {
+      fields[id] = Size();
+      
+      if (id + 1 > fieldCount) {
+        fieldCount = id + 1;
+      }
+    }
+    
+    char *buffer;
+    size_t capacity;
+    size_t head;
+    size_t minAlign;
+    bool failed;
+    size_t tableStart;
+    size_t fields[ARROW_MAX_TABLE_FIELDS];
+    int fieldCount;
+};
+
+//Arrow format constants, from Schema.fbs and Message.fbs
+#define ARROW_METADATA_V5          4
+#define ARROW_HEADER_SCHEMA        1
+#define ARROW_HEADER_RECORD_BATCH  3
+#define ARROW_TYPE_INT             2
+#define ARROW_TYPE_FLOATING_POINT  3
+#define ARROW_TYPE_BINARY          4
+#define ARROW_TYPE_UTF8            5
+#define ARROW_TYPE_BOOL            6
+#define ARROW_TYPE_TIMESTAMP       10
+#define ARROW_PRECISION_DOUBLE     2
+#define ARROW_UNIT_MILLISECOND     1
+
+/*
+ * GetArrowType
+ *
+ * The Arrow type of a FETCH_COLUMNAR vector: DATETIME milliseconds become
+ * timestamps, BYTE data binary and all other character data UTF-8.
+ */
+
+static uint8_t GetArrowType(Column column, ColumnVector* vector)
+{
+  switch (vector->c_type)
+  {
+    case SQL_C_SLONG :
+    case SQL_C_SBIGINT :
+      return ARROW_TYPE_INT;
+
+    case SQL_C_DOUBLE :
+      switch ((int) column.type) {
+        case SQL_DATETIME :
+        case SQL_TIMESTAMP :
+        case SQL_TYPE_TIMESTAMP :
+          return ARROW_TYPE_TIMESTAMP;
+        default :
+          return ARROW_TYPE_FLOATING_POINT;
+      }
+
+    case SQL_C_BIT :
+      return ARROW_TYPE_BOOL;
+
+    default :
+      return ((int) column.type == SQL_LONGVARBINARY) ? ARROW_TYPE_BINARY : ARROW_TYPE_UTF8;
+  }
+}
+
+#ifdef UNICODE
+/*
+ * ArrowUtf8Vector
+ *
+ * Replaces the UTF-16 character data of a vector with UTF-8, rewriting its
+ * offsets. Returns false when memory runs out.
+ */
+
+static bool ArrowUtf8Vector(ColumnVector* vector)
+{
+  size_t capacity = vector->dataLength / 2 * 3 + 1;
+  char *utf8 = (char *) malloc(capacity);
+
+  if (utf8 == NULL) {
+    return false;
+  }
+
+  uint16_t *utf16 = (uint16_t *) vector->values;
+  size_t length = 0;
+  int32_t start = 0;
+
+  for (SQLULEN row = 0; row < vector->rowCount; row++) {
+    int32_t end = vector->offsets[row + 1] / 2;
+
+    length += Utf16ToUtf8(utf16 + start, end - start, utf8 + length);
+    vector->offsets[row + 1] = (int32_t) length;
+    start = end;
+  }
+
+  free(vector->values);
+  vector->values = utf8;
+  vector->dataLength = length;
+  vector->dataCapacity = capacity;
+
+  return true;
+}
+#endif
+
+/*
+ * CreateArrowSchema
+ */
+
+static uint32_t CreateArrowSchema(ArrowMetadata* fb, Column* columns, ColumnVector* vectors,
+                                  short colCount)
+{
+  uint32_t *fields = (uint32_t *) malloc((colCount > 0 ? colCount : 1) * sizeof(uint32_t));
+
+  if (fields == NULL) {
+    return 0;
+  }
+
+  for (int i = 0; i < colCount; i++) {
+    uint8_t type = GetArrowType(columns[i], &vectors[i]);
+#ifdef UNICODE
+    char utf8[MAX_FIELD_SIZE * 3 / 2];
+    uint32_t name = fb->CreateString(utf8, Utf16ToUtf8((uint16_t *) columns[i].name, columns[i].len / 2, utf8));
+#else
+    uint32_t name = fb->CreateString((const char *) columns[i].name, columns[i].len);
+#endif
+    uint32_t timezone = 0;
+
+    if (type == ARROW_TYPE_TIMESTAMP) {
+      timezone = fb->CreateString("UTC", 3);
+    }
+
+    fb->StartTable();
+    switch (type) {
+      case ARROW_TYPE_INT :
+        fb->AddField<int32_t>(0, vectors[i].c_type == SQL_C_SBIGINT ? 64 : 32);
+        fb->AddField<uint8_t>(1, 1);
+        break;
+      case ARROW_TYPE_FLOATING_POINT :
+        fb->AddField<int16_t>(0, ARROW_PRECISION_DOUBLE);
+        break;
+      case ARROW_TYPE_TIMESTAMP :
+        fb->AddField<int16_t>(0, ARROW_UNIT_MILLISECOND);
+        fb->AddOffset(1, timezone);
+        break;
+    }
+    uint32_t typeTable = fb->EndTable();
+
+    //readers expect a children vector even when it is empty
+    fb->StartVector(0, sizeof(uint32_t), sizeof(uint32_t));
+    uint32_t children = fb->EndVector(0);
+
+    fb->StartTable();
+    fb->AddOffset(0, name);
+    fb->AddField<uint8_t>(1, 1);
+    fb->AddField<uint8_t>(2, type);
+    fb->AddOffset(3, typeTable);
+    fb->AddOffset(5, children);
+    fields[i] = fb->EndTable();
+  }
+
+  fb->StartVector(colCount, sizeof(uint32_t), sizeof(uint32_t));
+  for (int i = colCount - 1; i >= 0; i--) {
+    fb->PushOffset(fields[i]);
+  }
+  uint32_t fieldVector = fb->EndVector(colCount);
+
+  free(fields);
+
+  fb->StartTable();
+  fb->AddField<int16_t>(0, 0);
+  fb->AddOffset(1, fieldVector);
+
+  return fb->EndTable();
+}
+
+/*
+ * ArrowColumn
+ *
+ * Where the buffers of one column go in the body of the record batch.
+ */
+
+typedef struct {
+  uint8_t   type;
+  int64_t   nullCount;
+  int       bufferCount;
+  int64_t   offsets[3];
+  int64_t   lengths[3];
+} ArrowColumn;
+
+static int64_t ArrowPadded(int64_t length)
+{
+  return (length + 7) & ~((int64_t) 7);
+}
+
+
+/*
+ * GetArrowStream
+ *
+ * Encodes the FETCH_COLUMNAR vectors as an Arrow IPC stream: the schema,
+ * one record batch with every row and the end-of-stream marker. Returns a
+ * malloc'd block of *length bytes, or NULL when memory runs out. Does not
+ * touch V8 so it can run on the thread pool.
+ */
+
+char* ODBC::GetArrowStream(Column* columns, ColumnVector* vectors, short colCount, size_t* length)
+{
+  DEBUG_PRINTF("ODBC::GetArrowStream colCount=%i\n", colCount);
+
+  ArrowMetadata schema, batch;
+  ArrowColumn *layout = (ArrowColumn *) calloc(colCount > 0 ? colCount : 1, sizeof(ArrowColumn));
+  int64_t rowCount = colCount > 0 ? (int64_t) vectors[0].rowCount : 0;
+  int64_t bodyLength = 0;
+  int bufferCount = 0;
+
+  if (layout == NULL) {
+    return NULL;
+  }
+
+  //the schema message
+  uint32_t schemaTable = CreateArrowSchema(&schema, columns, vectors, colCount);
+  schema.StartTable();
+  schema.AddField<int16_t>(0, ARROW_METADATA_V5);
+  schema.AddField<uint8_t>(1, ARROW_HEADER_SCHEMA);
+  schema.AddOffset(2, schemaTable);
+  schema.AddField<int64_t>(3, 0);
+  schema.Finish(schema.EndTable());
+
+  //lay out the body: a validity bitmap, then values or offsets and data
+  for (int i = 0; i < colCount; i++) {
+    ColumnVector *vector = &vectors[i];
+    ArrowColumn *column = &layout[i];
+    int64_t lengths[3] = {0, 0, 0};
+
+    column->type = GetArrowType(columns[i], vector);
+
+#ifdef UNICODE
+    if (column->type == ARROW_TYPE_UTF8 && !ArrowUtf8Vector(vector)) {
+      free(layout);
+      return NULL;
+    }
+#endif
+
+    for (SQLULEN row = 0; row < vector->rowCount; row++) {
+      if (vector->nulls[row >> 3] & (1 << (row & 7))) {
+        column->nullCount++;
+      }
+    }
+
+    if (column->nullCount > 0) {
+      lengths[0] = (rowCount + 7) / 8;
+    }
+
+    switch (column->type) {
+      case ARROW_TYPE_UTF8 :
+      case ARROW_TYPE_BINARY :
+        column->bufferCount = 3;
+        lengths[1] = (rowCount + 1) * sizeof(int32_t);
+        lengths[2] = vector->dataLength;
+        break;
+      case ARROW_TYPE_BOOL :
+        column->bufferCount = 2;
+        lengths[1] = (rowCount + 7) / 8;
+        break;
+      case ARROW_TYPE_TIMESTAMP :
+        column->bufferCount = 2;
+        lengths[1] = rowCount * sizeof(int64_t);
+        break;
+      default :
+        column->bufferCount = 2;
+        lengths[1] = rowCount * vector->width;
+    }
+
+    for (int b = 0; b < column->bufferCount; b++) {
+      column->offsets[b] = bodyLength;
+      column->lengths[b] = lengths[b];
+      bodyLength += ArrowPadded(lengths[b]);
+    }
+
+    bufferCount += column->bufferCount;
+  }
+
+  //the record batch message
+  batch.StartVector(bufferCount, 2 * sizeof(int64_t), sizeof(int64_t));
+  for (int i = colCount - 1; i >= 0; i--) {
+    for (int b = layout[i].bufferCount - 1; b >= 0; b--) {
+      int64_t buffer[2] = {layout[i].offsets[b], layout[i].lengths[b]};
+      batch.PushBytes(buffer, sizeof(buffer));
+    }
+  }
+  uint32_t buffers = batch.EndVector(bufferCount);
+
+  batch.StartVector(colCount, 2 * sizeof(int64_t), sizeof(int64_t));
+  for (int i = colCount - 1; i >= 0; i--) {
+    int64_t node[2] = {rowCount, layout[i].nullCount};
+    batch.PushBytes(node, sizeof(node));
+  }
+  uint32_t nodes = batch.EndVector(colCount);
+
+  batch.StartTable();
+  batch.AddField<int64_t>(0, rowCount);
+  batch.AddOffset(1, nodes);
+  batch.AddOffset(2, buffers);
+  uint32_t batchTable = batch.EndTable();
+
+  batch.StartTable();
+  batch.AddField<int16_t>(0, ARROW_METADATA_V5);
+  batch.AddField<uint8_t>(1, ARROW_HEADER_RECORD_BATCH);
+  batch.AddOffset(2, batchTable);
+  batch.AddField<int64_t>(3, bodyLength);
+  batch.Finish(batch.EndTable());
+
+  if (schema.Failed() || batch.Failed()) {
+    free(layout);
+    return NULL;
+  }
+
+  //each message is a continuation marker, the metadata length, the metadata
+  //padded to 8 bytes and the body
+  int32_t schemaLength = (int32_t) ArrowPadded(schema.Size());
+  int32_t batchLength = (int32_t) ArrowPadded(batch.Size());
+  size_t total = 8 + schemaLength + 8 + batchLength + bodyLength + 8;
+  char *stream = (char *) calloc(1, total);
+  char *p = stream;
+  int32_t marker = -1;
+  int32_t end = 0;
+
+  if (stream == NULL) {
+    free(layout);
+    return NULL;
+  }
+
+  memcpy(p, &marker, 4);
+  memcpy(p + 4, &schemaLength, 4);
+  memcpy(p + 8, schema.Data(), schema.Size());
+  p += 8 + schemaLength;
+
+  memcpy(p, &marker, 4);
+  memcpy(p + 4, &batchLength, 4);
+  memcpy(p + 8, batch.Data(), batch.Size());
+  p += 8 + batchLength;
+
+  for (int i = 0; i < colCount; i++) {
+    ColumnVector *vector = &vectors[i];
+    ArrowColumn *column = &layout[i];
+    uint8_t *validity = (uint8_t *) p + column->offsets[0];
+    char *values = p + column->offsets[1];
+
+    //Arrow sets the bit of every row that is not NULL
+    for (int64_t b = 0; b < column->lengths[0]; b++) {
+      validity[b] = (uint8_t) ~vector->nulls[b];
+    }
+    if (column->lengths[0] > 0 && (rowCount & 7)) {
+      validity[column->lengths[0] - 1] &= (uint8_t) ((1 << (rowCount & 7)) - 1);
+    }
+
+    switch (column->type) {
+      case ARROW_TYPE_UTF8 :
+      case ARROW_TYPE_BINARY :
+        memcpy(values, vector->offsets, column->lengths[1]);
+        if (column->lengths[2] > 0) {
+          memcpy(p + column->offsets[2], vector->values, column->lengths[2]);
+        }
+        break;
+
+      case ARROW_TYPE_BOOL :
+        for (int64_t row = 0; row < rowCount; row++) {
+          if (vector->values[row]) {
+            values[row >> 3] |= (char) (1 << (row & 7));
+          }
+        }
+        break;
+
+      case ARROW_TYPE_TIMESTAMP :
+        for (int64_t row = 0; row < rowCount; row++) {
+          ((int64_t *) values)[row] = (int64_t) ((double *) vector->values)[row];
+        }
+        break;
+
+      default :
+        if (column->lengths[1] > 0) {
+          memcpy(values, vector->values, column->lengths[1]);
+        }
+    }
+  }
+  p += bodyLength;
+
+  memcpy(p, &marker, 4);
+  memcpy(p + 4, &end, 4);
+
+  free(layout);
+
+  *length = total;
+
+  return stream;
+}
+
+/*
+ * ReserveExportBuffer
+ *
+ * Makes room for length more bytes of text. Returns false when memory runs
+ * out.
+ */
+
+static bool ReserveExportBuffer(ExportBuffer* out, size_t length)
+{
+  if (out->length + length <= out->capacity) {
+    return true;
+  }
+
+  size_t capacity = out->capacity ? out->capacity : EXPORT_BLOCK_SIZE;
+
+  while (capacity < out->length + length) {
+    capacity *= 2;
+  }
+
+  char *data = (char *) realloc(out->data, capacity);
+
+  if (data == NULL) {
+    return false;
+  }
+
+  out->data = data;
+  out->capacity = capacity;
+
+  return true;
+}
+
+static bool AppendExport(ExportBuffer* out, const char* text, size_t length)
+{
+  if (!ReserveExportBuffer(out, length)) {
+    return false;
+  }
+
+  memcpy(out->data + out->length, text, length);
+  out->length += length;
+
+  return true;
+}
+
+/*
+ * AppendExportText
+ *
+ * Appends UTF-8 text as a field: quoted, with embedded quotes doubled,
+ * when a CSV field needs it, and always quoted and escaped for JSON.
+ */
+
+static bool AppendExportText(ExportBuffer* out, const char* text, size_t length, int format)
+{
+  //at worst every byte becomes a \u00XX escape
+  if (!ReserveExportBuffer(out, length * 6 + 2)) {
+    return false;
+  }
+
+  char *p = out->data + out->length;
+
+  if (format == EXPORT_CSV) {
+    bool quote = false;
+
+    for (size_t i = 0; i < length && !quote; i++) {
+      quote = (text[i] == ',' || text[i] == '"' || text[i] == '\n' || text[i] == '\r');
+    }
+
+    if (!quote) {
+      memcpy(p, text, length);
+      out->length += length;
+      return true;
+    }
+
+    *p++ = '"';
+    for (size_t i = 0; i < length; i++) {
+      if (text[i] == '"') {
+        *p++ = '"';
+      }
+      *p++ = text[i];
+    }
+    *p++ = '"';
+  }
+  else {
+    static const char hex[] = "0123456789abcdef";
+
+    *p++ = '"';
+    for (size_t i = 0; i < length; i++) {
+      unsigned char c = (unsigned char) text[i];
+
+      switch (c) {
+        case '"' : *p++ = '\\'; *p++ = '"'; break;
+        case '\\' : *p++ = '\\'; *p++ = '\\'; break;
+        case '\n' : *p++ = '\\'; *p++ = 'n'; break;
+        case '\r' : *p++ = '\\'; *p++ = 'r'; break;
+        case '\t' : *p++ = '\\'; *p++ = 't'; break;
+        case '\b' : *p++ = '\\'; *p++ = 'b'; break;
+        case '\f' : *p++ = '\\'; *p++ = 'f'; break;
+        default :
+          if (c < 0x20) {
+            memcpy(p, "\\u00", 4);
+            p[4] = hex[c >> 4];
+            p[5] = hex[c & 15];
+            p += 6;
+          }
+          else {
+            *p++ = (char) c;
+          }
+      }
+    }
+    *p++ = '"';
+  }
+
+  out->length = p - out->data;
+
+  return true;
+}
+
+/*
+ * AppendExportString
+ *
+ * Appends character data as fetched, UTF-16 in UNICODE builds, as text.
+ */
+
+static bool AppendExportString(ExportBuffer* out, const char* value, size_t length, int format)
+{
+#ifdef UNICODE
+  size_t needed = length / 2 * 3;
+
+  if (needed > out->textCapacity) {
+    char *text = (char *) realloc(out->text, needed);
+
+    if (text == NULL) {
+      return false;
+    }
+
+    out->text = text;
+    out->textCapacity = needed;
+  }
+
+  length = Utf16ToUtf8((const uint16_t *) value, length / 2, out->text);
+  value = out->text;
+#endif
+
+  return AppendExportText(out, value, length, format);
+}
+
+/*
+ * AppendExportDouble
+ *
+ * The shortest text that reads back as the same double, as JSON.stringify
+ * writes it. Infinities and NaN have no JSON form and are exported as NULL.
+ */
+
+static bool AppendExportDouble(ExportBuffer* out, double value, int format)
+{
+  char text[32];
+  int length = 0;
+
+  if (value != value || value > DBL_MAX || value < -DBL_MAX) {
+    return (format == EXPORT_CSV) ? true : AppendExport(out, "null", 4);
+  }
+
+  for (int precision = 15; precision <= 17; precision++) {
+    length = snprintf(text, sizeof(text), "%.*g", precision, value);
+
+    if (strtod(text, NULL) == value) {
+      break;
+    }
+  }
+
+  return AppendExport(out, text, length);
+}
+
+/*
+ * AppendExportHeader
+ *
+ * The CSV header line with the column names.
+ */
+
+bool ODBC::AppendExportHeader(Column* columns, short colCount, ExportBuffer* out)
+{
+  for (int i = 0; i < colCount; i++) {
+    if ((i > 0 && !AppendExport(out, ",", 1)) ||
+        !AppendExportString(out, (const char *) columns[i].name, columns[i].len, EXPORT_CSV)) {
+      return false;
+    }
+  }
+
+  return AppendExport(out, "\n", 1);
+}
+
+/*
+ * FormatTimestampMs
+ *
+ * Writes milliseconds since the epoch the way Date.prototype.toISOString
+ * does, which is how the Date values of fetchAll are serialized, so that an
+ * export and JSON.stringify of the fetched rows agree. Returns the length.
+ */
+
+static int FormatTimestampMs(double ms, char* text, size_t size)
+{
+  int64_t total = (int64_t) ms;
+  int64_t days = (total >= 0 ? total : total - 86399999) / 86400000;
+  int64_t rest = total - days * 86400000;
+
+  //civil date of days since 1970-01-01, the inverse of DaysFromCivil
+  int64_t z = days + 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  unsigned dayOfEra = (unsigned) (z - era * 146097);
+  unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+  unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+  unsigned mp = (5 * dayOfYear + 2) / 153;
+  unsigned day = dayOfYear - (153 * mp + 2) / 5 + 1;
+  unsigned month = mp < 10 ? mp + 3 : mp - 9;
+  int64_t year = (int64_t) yearOfEra + era * 400 + (month <= 2);
+
+  return snprintf(text, size,
+                  (year >= 0 && year <= 9999)
+                    ? "%04lld-%02u-%02uT%02d:%02d:%02d.%03dZ"
+                    : "%+07lld-%02u-%02uT%02d:%02d:%02d.%03dZ",
+                  (long long) year, month, day,
+                  (int) (rest / 3600000), (int) (rest / 60000 % 60),
+                  (int) (rest / 1000 % 60), (int) (rest % 1000));
+}
+
+/*
+ * AppendExportRow
+ *
+ * Formats one row of buffers, either a bound rowset or a row read with
+ * FetchRowData, as a CSV line or an NDJSON object. Values are written as
+ * the rows of fetchAll would be serialized with the same flags; NULL is an
+ * empty CSV field. Does not touch V8 so it can run on the thread pool.
+ * Returns false when memory runs out.
+ */
+
+bool ODBC::AppendExportRow(Column* columns, short colCount, ColumnBuffer* buffers, SQLULEN row,
+                           int format, int flags, ExportBuffer* out)
+{
+#ifdef UNICODE
+  int terCharLen = 2;
+#else
+  int terCharLen = 1;
+#endif
+  bool json = (format == EXPORT_NDJSON);
+  char text[64];
+  bool ok = true;
+
+  if (json) {
+    ok = AppendExport(out, "{", 1);
+  }
+
+  for (int i = 0; i < colCount && ok; i++) {
+    ColumnBuffer *buffer = &buffers[i];
+    SQLLEN len = buffer->indicators[row];
+    char *value = buffer->buffer + (row * buffer->width);
+
+    if (i > 0) {
+      ok = AppendExport(out, ",", 1);
+    }
+
+    if (json && ok) {
+      ok = AppendExportString(out, (const char *) columns[i].name, columns[i].len, EXPORT_NDJSON) &&
+           AppendExport(out, ":", 1);
+    }
+
+    if (!ok) {
+      break;
+    }
+
+    if (len == SQL_NULL_DATA) {
+      if (json) {
+        ok = AppendExport(out, "null", 4);
+      }
+      continue;
+    }
+
+    switch (buffer->c_type)
+    {
+      case SQL_C_SLONG :
+        ok = AppendExport(out, text, snprintf(text, sizeof(text), "%d", (int) *(SQLINTEGER *) value));
+        break;
+
+      case SQL_C_DOUBLE :
+        ok = AppendExportDouble(out, *(double *) value, format);
+        break;
+
+      case SQL_C_SBIGINT :
+        snprintf(text, sizeof(text), "%lld", (long long) *(SQLBIGINT *) value);
+
+        //BIGINT values are strings unless bigintMode asks for numbers
+        if (json && !(flags & (VALUE_BIGINT_NUMBER | VALUE_BIGINT_BIGINT))) {
+          ok = AppendExportText(out, text, strlen(text), format);
+        }
+        else {
+          ok = AppendExport(out, text, strlen(text));
+        }
+        break;
+
+      case SQL_C_TYPE_TIMESTAMP : {
+        SQL_TIMESTAMP_STRUCT *odbcTime = (SQL_TIMESTAMP_STRUCT *) value;
+
+        if (flags & VALUE_TIMESTAMP_NUMBER) {
+          ok = AppendExportDouble(out, GetTimestampMs(*odbcTime), format);
+        }
+        else {
+          int length = FormatTimestampMs(GetTimestampMs(*odbcTime), text, sizeof(text));
+          ok = AppendExportText(out, text, length, format);
+        }
+        break;
+      }
+
+      case SQL_C_BINARY : {
+        static const char hex[] = "0123456789abcdef";
+
+        if (len == SQL_NO_TOTAL || len > buffer->width) {
+          len = buffer->width;
+        }
+
+        //binary values are exported as hex text
+        if (!ReserveExportBuffer(out, len * 2 + 2)) {
+          ok = false;
+          break;
+        }
+        if (json) {
+          out->data[out->length++] = '"';
+        }
+        for (SQLLEN b = 0; b < len; b++) {
+          out->data[out->length++] = hex[((unsigned char) value[b]) >> 4];
+          out->data[out->length++] = hex[((unsigned char) value[b]) & 15];
+        }
+        if (json) {
+          out->data[out->length++] = '"';
+        }
+        break;
+      }
+
+      default :
+        if ((int) columns[i].type == SQL_BIT) {
+          ok = (*value == '0') ? AppendExport(out, "false", 5) : AppendExport(out, "true", 4);
+          break;
+        }
+
+        //the driver truncates values which do not fit in the bound width
+        if (len == SQL_NO_TOTAL || len > buffer->width - terCharLen) {
+          len = buffer->width - terCharLen;
+        }
+
+        if ((flags & VALUE_TRIM_CHAR) && IsCharColumn(columns[i])) {
+          len = TrimmedLength(value, len);
+        }
+
+        ok = AppendExportString(out, value, len, format);
+    }
+  }
+
+  if (ok) {
+    ok = json ? AppendExport(out, "}\n", 2) : AppendExport(out, "\n", 1);
+  }
+
+  return ok;
+}
+
+/*
+ * FreeExportBuffer
+ */
+
+void ODBC::FreeExportBuffer(ExportBuffer* out)
+{
+  free(out->data);
+  out->data = NULL;
+  out->length = 0;
+  out->capacity = 0;
+#ifdef UNICODE
+  free(out->text);
+  out->text = NULL;
+  out->textCapacity = 0;
+#endif
+}
+
+/*
+ * FreeExternalBuffer
+ */
+
+static void FreeExternalBuffer(char* data, void* hint)
+{
+  free(data);
+}
+
+/*
+ * NewExternalBuffer
+ *
+ * Wraps malloc'd memory in a Buffer without copying it. V8 counts the
+ * backing store as external memory, so it adds to garbage collection
+ * pressure, and it is freed when the Buffer is collected.
+ */
+
+Local<Object> ODBC::NewExternalBuffer(char* data, size_t length)
+{
+  Nan::EscapableHandleScope scope;
+
+  if (data == NULL) {
+    return scope.Escape(Nan::NewBuffer(0).ToLocalChecked());
+  }
+
+  return scope.Escape(Nan::NewBuffer(data, length, FreeExternalBuffer, NULL).ToLocalChecked());
+}
+
+/*
+ * LazyColumnWidth
+ *
+ * The width a column of a rowset needs in NewLazyRowset: character values
+ * take the longest of the first rowCount values, with room for the
+ * terminator and rounded to 8; other values keep their bound width.
+ */
+
+static SQLLEN LazyColumnWidth(Column column, ColumnBuffer* buffer, SQLULEN rowCount)
+{
+#ifdef UNICODE
+  int terCharLen = 2;
+#else
+  int terCharLen = 1;
+#endif
+  
+  switch (buffer->c_type) {
+    case SQL_C_SLONG :
+    case SQL_C_DOUBLE :
+    case SQL_C_SBIGINT :
+    case SQL_C_TYPE_TIMESTAMP :
+      return buffer->width;
+    default :
+      if ((int) column.type == SQL_BIT) {
+        return buffer->width;
+      }
+  }
+  
+  SQLLEN longest = 0;
+  
+  for (SQLULEN row = 0; row < rowCount; row++) {
+    SQLLEN len = buffer->indicators[row];
+    
+    if (len == SQL_NO_TOTAL || len > buffer->width - terCharLen) {
+      len = buffer->width - terCharLen;
+    }
+    
+    if (len > longest) {
+      longest = len;
+    }
+  }
+  
+  return (longest + terCharLen + 7) & ~7;
+}
+
+/*
+ * NewLazyRowset
+ *
+ * Copies the first rowCount rows of a bound rowset, with the metadata needed
+ * to convert them, into a Buffer for GetLazyRecord. Character columns are
+ * narrowed to their longest value, so short values of wide columns do not
+ * keep their padding. The rowset can then be fetched into again while the
+ * rows stay readable for as long as a row refers to the Buffer: a single
+ * row that is kept keeps the values of every row of its rowset. Returns
+ * undefined when out of memory.
+ */
+
+Local<Value> ODBC::NewLazyRowset(Column* columns, short colCount, ColumnBuffer* buffers,
+                                 SQLULEN rowCount, int flags)
+{
+  Nan::EscapableHandleScope scope;
+#ifdef UNICODE
+  int terCharLen = 2;
+#else
+  int terCharLen = 1;
+#endif
+  
+  size_t header = (sizeof(LazyRowset) + colCount * (sizeof(Column) + sizeof(ColumnBuffer)) + 7) & ~7;
+  size_t length = header;
+  SQLLEN *widths = (SQLLEN *) malloc((colCount > 0 ? colCount : 1) * sizeof(SQLLEN));
+  
+  if (!widths) {
+    return scope.Escape(Nan::Undefined());
+  }
+  
+  for (int i = 0; i < colCount; i++) {
+    widths[i] = LazyColumnWidth(columns[i], &buffers[i], rowCount);
+    length += rowCount * (widths[i] + sizeof(SQLLEN));
+  }
+  
+  char *block = (char *) malloc(length);
+  
+  if (!block) {
+    free(widths);
+    return scope.Escape(Nan::Undefined());
+  }
+  
+  LazyRowset *rowset = (LazyRowset *) block;
+  char *next = block + header;
+  
+  rowset->columns = (Column *) (block + sizeof(LazyRowset));
+  rowset->buffers = (ColumnBuffer *) (rowset->columns + colCount);
+  rowset->colCount = colCount;
+  rowset->flags = flags;
+  rowset->rowCount = rowCount;
+  
+  for (int i = 0; i < colCount; i++) {
+    rowset->columns[i] = columns[i];
+    rowset->columns[i].name = NULL;
+    rowset->columns[i].type_name = NULL;
+    
+    //widths are multiples of 8, so every array stays aligned
+    rowset->buffers[i].c_type = buffers[i].c_type;
+    rowset->buffers[i].width = widths[i];
+    rowset->buffers[i].buffer = next;
+    
+    char *values = next;
+    
+    next += rowCount * widths[i];
+    rowset->buffers[i].indicators = (SQLLEN *) next;
+    memcpy(next, buffers[i].indicators, rowCount * sizeof(SQLLEN));
+    next += rowCount * sizeof(SQLLEN);
+    
+    if (widths[i] == buffers[i].width) {
+      memcpy(values, buffers[i].buffer, rowCount * buffers[i].width);
+      continue;
+    }
+    
+    for (SQLULEN row = 0; row < rowCount; row++) {
+      SQLLEN *len = &rowset->buffers[i].indicators[row];
+      
+      memcpy(values + row * widths[i], buffers[i].buffer + row * buffers[i].width, widths[i]);
+      
+      //truncated values keep the length they were truncated to, which the
+      //narrowed width alone would no longer tell
+      if (*len == SQL_NO_TOTAL || *len > buffers[i].width - terCharLen) {
+        *len = buffers[i].width - terCharLen;
+      }
+    }
+  }
+  
+  free(widths);
+  
+  return scope.Escape(NewExternalBuffer(block, length));
+}
+
+/*
+ * GetLazyRecord
+ *
+ * A FETCH_LAZY row: an instance of the template from GetLazyRowTemplate that
+ * points to row of a rowset from NewLazyRowset.
+ */
+
+Local<Object> ODBC::GetLazyRecord(Local<ObjectTemplate> rowTemplate, Local<Value> rowset, SQLULEN row)
+{
+  Nan::EscapableHandleScope scope;
+  
+  Local<Object> record = Nan::NewInstance(rowTemplate).ToLocalChecked();
+  
+  record->SetInternalField(0, rowset);
+  record->SetInternalField(1, Nan::New<Integer>((uint32_t) row));
+  
+  return scope.Escape(record);
+}
+
+/*
+ * LazyValueGetter
+ *
+ * Converts the value of a FETCH_LAZY row when its property is read. The
+ * accessor data is the column index.
+ */
+
+NAN_GETTER(ODBC::LazyValueGetter) {
+  Local<Object> record = info.Holder();
+  
+  LazyRowset *rowset = (LazyRowset *) node::Buffer::Data(record->GetInternalField(0));
+  SQLULEN row = Nan::To<uint32_t>(record->GetInternalField(1)).FromJust();
+  int column = Nan::To<int32_t>(info.Data()).FromJust();
+  
+  info.GetReturnValue().Set(GetColumnBufferValue(rowset->columns[column],
+                                                 &rowset->buffers[column],
+                                                 row,
+                                                 rowset->flags));
+}
+
+/*
+ * GetOutputParameter
+ */
+
+Local<Value> ODBC::GetOutputParameter( Parameter prm ) 
+{
+  Nan::EscapableHandleScope scope;
+  Local<String> str;
+
+  DEBUG_PRINTF("SQL Type of parameter: %i\n",prm.type);
+  switch ((int) prm.type) 
+  {
+    case SQL_INTEGER : 
+    case SQL_SMALLINT :
+    case SQL_TINYINT : 
+    case SQL_NUMERIC :
+        if((int) prm.type == SQL_NUMERIC)
+          DEBUG_PRINTF("NUMERIC DATA SELECTED\n");
+    case SQL_BIGINT :
+        if((int) prm.type == SQL_BIGINT)
+          DEBUG_PRINTF("BIGINT DATA SELECTED\n");
+      {
+        if((int)prm.length == SQL_NULL_DATA)
+        {
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
+                       "c_type=%i type=%i buf_len=%i len=%i val=%i\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, prm.buffer);
+          return scope.Escape(Nan::Null());
+        }
+        else if((int)prm.length == sizeof(int)){
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
+                       "c_type=%i type=%i buf_len=%i len=%i intval=%i\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, *(int*)prm.buffer);
+          return scope.Escape(Nan::New<Number>(*(int*)prm.buffer));
+        }
+        else if((int)prm.length == sizeof(short)){
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
+                       "c_type=%i type=%i buf_len=%i len=%i shortval=%i\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, *(short*)prm.buffer);
+          return scope.Escape(Nan::New<Number>(*(short*)prm.buffer));
+        }
+        else if((int)prm.length == sizeof(long)){
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
+                       "c_type=%i type=%i buf_len=%i len=%i longval=%i\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, *(long*)prm.buffer);
+          return scope.Escape(Nan::New<Number>(*(long*)prm.buffer));
+        }
+        else {
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Integer: paramtype=%i "
+                       "c_type=%i type=%i buf_len=%i len=%i charval=%s\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, *(char*)prm.buffer);
+          return scope.Escape(Nan::New<Number>(*(char *)prm.buffer));
+        }
+      }
+      break;
+
+    case SQL_DECIMAL :
+        if((int) prm.type == SQL_DECIMAL)
+          DEBUG_PRINTF("DECIMAL DATA SELECTED\n");
+    case SQL_FLOAT :
+    case SQL_REAL :
+    case SQL_DOUBLE : 
+      {
+        if((int)prm.length == SQL_NULL_DATA)
+        {
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Number: paramtype=%i c_type=%i "
+                       "type=%i buf_len=%i len=%i nullval=%f\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, prm.buffer);
+          return scope.Escape(Nan::Null());
+        }
+        else {
+          DEBUG_PRINTF("ODBC::GetOutputParameter - Number: paramtype=%i c_type=%i "
+                       "type=%i buf_len=%i len=%i floatval=%f\n", 
+                       prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                       prm.length, *(double*)prm.buffer);
+          return scope.Escape(Nan::New<Number>(*(double*)prm.buffer));
+        }
+      }
+      break;
+
+    case SQL_BIT :
+      {
+        DEBUG_PRINTF("ODBC::GetOutputParameter - Bit: paramtype=%i c_type=%i type=%i buf_len=%i len=%i val=%f\n", 
+                     prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                     prm.length, prm.buffer);
+        if((int)prm.length == SQL_NULL_DATA) {
+            return scope.Escape(Nan::Null());
+        }
+        else {
+            return scope.Escape(Nan::New((*((char*)prm.buffer) == '0') ? false : true));
+        }
+      }
+      break;
+	/*
+    case SQL_BLOB :
+    case SQL_DATETIME :
+    case SQL_TIMESTAMP : 
+    */
+    case SQL_TYPE_TIME:
+		DEBUG_PRINTF("SQL_TIME SELECTED\n");
+    default :
+      DEBUG_PRINTF("ODBC::GetOutputParameter - String: paramtype=%i c_type=%i type=%i buf_len=%i len=%i val=%s\n", 
+                   prm.paramtype, prm.c_type, prm.type, prm.buffer_length,
+                   prm.length, prm.buffer);
+      if((int)prm.length == SQL_NULL_DATA) {
+          return scope.Escape(Nan::Null());
+      }
+      if(prm.c_type == SQL_C_BINARY)
+          str = Nan::NewOneByteString((uint8_t *) prm.buffer, prm.length).ToLocalChecked();
+      else {
+        #ifdef UNICODE
+        str = Nan::New((uint16_t *) prm.buffer).ToLocalChecked();
+        #else
+        str = Nan::New((char *) prm.buffer).ToLocalChecked();
+        #endif
+      }
+      return scope.Escape(str);
+  }
+}
+
+/*
+ * GetRecordTuple
+ */
+
+Local<Object> ODBC::GetRecordTuple ( SQLHSTMT hStmt, Column* columns, 
+                                         short* colCount, ScratchBuffer* scratch,
+                                         Nan::Persistent<String>* names,
+                                         Local<ObjectTemplate> rowTemplate,
+                                         int flags, StringDictionary* dictionary) {
+  Nan::EscapableHandleScope scope;
+
+  Local<Object> tuple = rowTemplate.IsEmpty()
+    ? Nan::New<Object>()
+    : Nan::NewInstance(rowTemplate).ToLocalChecked();
+        
+  for(int i = 0; i < *colCount; i++) {
+    if (names != NULL) {
+      Nan::Set(tuple, Nan::New(names[i]),
+                GetColumnValue( hStmt, columns[i], scratch, flags, dictionary));
+      continue;
+    }
+#ifdef UNICODE
+    Nan::Set(tuple, Nan::New((uint16_t *) columns[i].name).ToLocalChecked(),
+                GetColumnValue( hStmt, columns[i], scratch, flags, dictionary));
+#else
+    Nan::Set(tuple, Nan::New((const char *) columns[i].name).ToLocalChecked(),
+                GetColumnValue( hStmt, columns[i], scratch, flags, dictionary));
+#endif
+  }
+  
+  return scope.Escape(tuple);
+}
+
+/*
+ * GetRecordArray
+ */
+
+Local<Value> ODBC::GetRecordArray ( SQLHSTMT hStmt, Column* columns, 
+                                         short* colCount, ScratchBuffer* scratch,
+                                         int flags, StringDictionary* dictionary) {
+  Nan::EscapableHandleScope scope;
+  
+  Local<Array> array = Nan::New<Array>();
+        
+  for(int i = 0; i < *colCount; i++) {
+    Nan::TryCatch try_catch;
+    Nan::Set(array, Nan::New(i),
+              GetColumnValue( hStmt, columns[i], scratch, flags, dictionary));
+    if (try_catch.HasCaught()) {
+        FatalException(try_catch);
+        break;
+    }
+  }
+  
+  return scope.Escape(array);
+}
+
+/*
+ * GetBufferedRecordTuple
+ */
+
+Local<Object> ODBC::GetBufferedRecordTuple ( Column* columns, short* colCount,
+                                             ColumnBuffer* buffers, SQLULEN row,
+                                             Nan::Persistent<String>* names,
+                                             Local<ObjectTemplate> rowTemplate,
+                                             int flags, StringDictionary* dictionary) {
+  Nan::EscapableHandleScope scope;
+
+  Local<Object> tuple = rowTemplate.IsEmpty()
+    ? Nan::New<Object>()
+    : Nan::NewInstance(rowTemplate).ToLocalChecked();
+        
+  for(int i = 0; i < *colCount; i++) {
+    if (names != NULL) {
+      Nan::Set(tuple, Nan::New(names[i]),
+                GetColumnBufferValue( columns[i], &buffers[i], row, flags, dictionary));
+      continue;
+    }
+#ifdef UNICODE
+    Nan::Set(tuple, Nan::New((uint16_t *) columns[i].name).ToLocalChecked(),
+                GetColumnBufferValue( columns[i], &buffers[i], row, flags, dictionary));
+#else
+    Nan::Set(tuple, Nan::New((const char *) columns[i].name).ToLocalChecked(),
+                GetColumnBufferValue( columns[i], &buffers[i], row, flags, dictionary));
+#endif
+  }
+  
+  return scope.Escape(tuple);
+}
+
+/*
+ * GetBufferedRecordArray
+ */
+
+Local<Value> ODBC::GetBufferedRecordArray ( Column* columns, short* colCount,
+                                            ColumnBuffer* buffers, SQLULEN row,
+                                            int flags, StringDictionary* dictionary) {
+  Nan::EscapableHandleScope scope;
+  
+  Local<Array> array = Nan::New<Array>();
+        
+  for(int i = 0; i < *colCount; i++) {
+    Nan::Set(array, Nan::New(i),
+              GetColumnBufferValue( columns[i], &buffers[i], row, flags, dictionary));
+  }
+  
+  return scope.Escape(array);
+}
+
+/*
+ * ArenaAlloc
+ *
+ * size bytes, 8 byte aligned, from the current block of arena or from a new
+ * one twice as big. NULL when out of memory.
+ */
+
+void* ODBC::ArenaAlloc(ParamArena* arena, size_t size) {
+  ArenaBlock *block = arena->blocks;
+
+  size = (size + 7) & ~7;
+
+  if (!block || block->used + size > block->capacity) {
+    size_t capacity = block ? block->capacity * 2 : PARAM_ARENA_BLOCK_SIZE;
+
+    if (capacity < size) {
+      capacity = size;
+    }
+
+    block = (ArenaBlock *) malloc(sizeof(ArenaBlock) + capacity);
+
+    if (!block) {
+      return NULL;
+    }
+
+    block->next = arena->blocks;
+    block->capacity = capacity;
+    block->used = 0;
+    arena->blocks = block;
+  }
+
+  void *ptr = (char *) (block + 1) + block->used;
+
+  block->used += size;
+  arena->allocated += size;
+
+  return ptr;
+}
+
+/*
+ * ResetParamArena
+ *
+ * Release everything allocated from arena. When that took more than one
+ * block, they are replaced by a single one with room for all of it, unless
+ * it would be over PARAM_ARENA_MAX_SIZE.
+ */
+
+void ODBC::ResetParamArena(ParamArena* arena) {
+  if (arena->blocks && !arena->blocks->next && arena->blocks->capacity <= PARAM_ARENA_MAX_SIZE) {
+    arena->blocks->used = 0;
+    arena->allocated = 0;
+    return;
+  }
+
+  size_t capacity = arena->allocated;
+
+  FreeParamArena(arena);
+
+  if (capacity > 0 && capacity <= PARAM_ARENA_MAX_SIZE) {
+    ArenaBlock *block = (ArenaBlock *) malloc(sizeof(ArenaBlock) + capacity);
+
+    if (block) {
+      block->next = NULL;
+      block->capacity = capacity;
+      block->used = 0;
+      arena->blocks = block;
+    }
+  }
+}
+
+void ODBC::FreeParamArena(ParamArena* arena) {
+  ArenaBlock *block = arena->blocks;
+
+  while (block) {
+    ArenaBlock *next = block->next;
+
+    free(block);
+    block = next;
+  }
+
+  arena->blocks = NULL;
+  arena->allocated = 0;
+}
+
+/*
+ * GetParametersFromArray
+ *
+ * The Parameters and the values they point to are allocated from arena and
+ * released with it.
+ */
+
+Parameter* ODBC::GetParametersFromArray (Local<Array> values, int *paramCount, ParamArena* arena) {
+  DEBUG_PRINTF("ODBC::GetParametersFromArray\n");
+  *paramCount = values->Length();
+  
+  if (*paramCount == 0) {
+    return NULL;
+  }
+  
+  Parameter* params = (Parameter *) ArenaAlloc(arena, *paramCount * sizeof(Parameter));
+  if( !params ) {
+      Nan::LowMemoryNotification();
+      Nan::ThrowError("Could not allocate enough memory for params in ODBC::GetParametersFromArray.");
+      return params;
+  }
+  memset(params, '\0', *paramCount * sizeof(Parameter));
+
+  for (int i = 0; i < *paramCount; i++) {
+    Local<Value> value = Nan::Get(values, i).ToLocalChecked();
+    
+    params[i].paramtype     = SQL_PARAM_INPUT;
+    params[i].size          = 0;
+    params[i].length        = SQL_NULL_DATA;
+    params[i].buffer_length = 0;
+    params[i].decimals      = 0;
+
+    DEBUG_PRINTF("ODBC::GetParametersFromArray - &param[%i].length = %p\n",
+                 i, &params[i].length);
+
+    if (value->IsArray()) 
+    {
+      Local<Value> val;
+      Local<Array> paramArray = Local<Array>::Cast(value);
+      int arrlen = paramArray->Length();
+      if(arrlen < 4)
+      {
+          DEBUG_PRINTF("ODBC::GetParametersFromArray - arrlen = %i\n", arrlen);
+          Nan::ThrowError("Wrong param format!");
+          return params;
+      }
+
+      val = Nan::Get(paramArray, 0).ToLocalChecked();
+      if(val->IsInt32())
+          params[i].paramtype = Nan::To<int32_t>(val).FromJust();
+
+      val = Nan::Get(paramArray, 1).ToLocalChecked();
+      if(val->IsInt32())
+          params[i].c_type = Nan::To<int32_t>(val).FromJust();
+      else
+          params[i].c_type = SQL_C_CHAR;
+
+      val = Nan::Get(paramArray, 2).ToLocalChecked();
+      if(val->IsInt32())
+          params[i].type = Nan::To<int32_t>(val).FromJust();
+      else
+          params[i].type = SQL_CHAR;
+
+      if(arrlen == 5)
+      {
+          val = Nan::Get(paramArray, 4).ToLocalChecked();
+          if(val->IsInt32())
+              params[i].buffer_length = Nan::To<int32_t>(val).FromJust();
+      }
+
+      val = Nan::Get(paramArray, 3).ToLocalChecked();
+      if (val->IsNull()) {
+          GetNullParam(&params[i], i+1);
+      }
+      else if (val->IsInt32()) {
+          GetInt32Param(val, &params[i], i+1, arena);
+      }
+      else if (val->IsNumber()) {
+          GetNumberParam(val, &params[i], i+1, arena);
+      }
+      else if (val->IsBoolean()) {
+          GetBoolParam(val, &params[i], i+1, arena);
+      }
+      else
+      {
+          GetStringParam(val, &params[i], i+1, arena);
+      }
+    }
+    else if (value->IsString()) {
+        GetStringParam(value, &params[i], i+1, arena);
+    }
+    else if (value->IsNull()) {
+        GetNullParam(&params[i], i+1);
+    }
+    else if (value->IsInt32()) {
+        GetInt32Param(value, &params[i], i+1, arena);
+    }
+    else if (value->IsNumber()) {
+        GetNumberParam(value, &params[i], i+1, arena);
+    }
+    else if (value->IsBoolean()) {
+        GetBoolParam(value, &params[i], i+1, arena);
+    }
+  } 
+  return params;
+}
+
+void ODBC::GetStringParam(Local<Value> value, Parameter * param, int num, ParamArena* arena)
+{
+    Local<String> string = value->TOSTRING;
+    int length = string->Length();
+    int bufflen = 0;
+      
+    param->length        = SQL_NTS;
+    if(!param->c_type || (param->c_type == SQL_CHAR))
+        param->c_type = SQL_C_TCHAR;
+    #ifdef UNICODE
+    if(!param->type || (param->type == SQL_CHAR))
+        param->type = (length >= 8000) ? SQL_WLONGVARCHAR : SQL_WVARCHAR;
+    if(param->c_type != SQL_C_BINARY)
+        bufflen = (length * sizeof(uint16_t)) + sizeof(uint16_t);
+    #else
+    if(!param->type || (param->type == SQL_CHAR))
+        param->type = (length >= 8000) ? SQL_LONGVARCHAR : SQL_VARCHAR;
+    if(param->c_type != SQL_C_BINARY)
+        bufflen = string->Utf8Length( ISOLATE ) + 1;
+    #endif
+    if(bufflen < param->buffer_length && (param->paramtype % 2 == 0))
+        bufflen = param->buffer_length;
+    param->buffer_length = bufflen;
+
+    if(param->c_type == SQL_C_BINARY || param->paramtype == FILE_PARAM)
+    {
+        param->buffer_length = length + 1; //null terminator added by WriteOneByte
+        param->length        = length; 
+    }
+    param->size          = param->buffer_length;
+    param->buffer        = ArenaAlloc(arena, param->buffer_length);
+    MEMCHECK( param->buffer );
+
+    if(param->paramtype == FILE_PARAM)
+        string->WriteUtf8( ISOLATECOMMA (char *) param->buffer );
+    else if(param->c_type == SQL_C_BINARY)
+    {
+#if (NODE_MODULE_VERSION < NODE_0_12_MODULE_VERSION)
+        memcpy(param->buffer, &string, param->buffer_length);
+        //param->buffer = &string;
+#else
+        string->WriteOneByte( ISOLATECOMMA (uint8_t *)param->buffer );
+#endif
+    }
+    else
+    {
+        #ifdef UNICODE
+        string->Write( ISOLATECOMMA (uint16_t *) param->buffer );
+        #else
+        string->WriteUtf8( ISOLATECOMMA (char *) param->buffer );
+        #endif
+    }
+
+    if(param->paramtype == FILE_PARAM)  // For SQLBindFileToParam()
+    {
+    /*
+       SQLRETURN SQLBindFileToParam (
+                 SQLHSTMT          StatementHandle,   // hstmt 
+                 SQLUSMALLINT      TargetType,        // i 
+                 SQLSMALLINT       DataType,          // type 
+                 SQLCHAR           *FileName,         // buffer
+                 SQLSMALLINT       *FileNameLength,   // NULL
+                 SQLUINTEGER       *FileOptions,      // SQL_FILE_READ = 2 -> fileOption
+                 SQLSMALLINT       MaxFileNameLength, // buffer_length -> decimals
+                 SQLINTEGER        *IndicatorValue);  // 0 -> fileIndicator
+    */
+        param->decimals = param->buffer_length;
+     //   param->fileOption = SQL_FILE_READ;
+        param->fileIndicator = 0;
+    }
+
+    DEBUG_PRINTF("ODBC::GetStringParam: param%u : paramtype=%u, c_type=%i, "
+                 "type=%i, size=%i, decimals=%i, buffer=%s, buffer_length=%i, "
+                 "length=%i\n", num, param->paramtype, param->c_type, 
+                 param->type, param->size, param->decimals, 
+                 (char *)param->buffer, param->buffer_length, param->length);
+}
+
+void ODBC::GetNullParam(Parameter * param, int num)
+{
+    param->c_type = SQL_C_DEFAULT;
+    param->type   = SQL_VARCHAR;
+    param->length = SQL_NULL_DATA;
+
+    DEBUG_PRINTF("ODBC::GetNullParam: param%u : paramtype=%u, c_type=%i, "
+                 "type=%i, size=%i, decimals=%i, buffer_length=%i, length=%i\n",
+                 num, param->paramtype, param->c_type, param->type, param->size,
+                 param->decimals, param->buffer_length, param->length);
+}
+
+void ODBC::GetInt32Param(Local<Value> value, Parameter * param, int num, ParamArena* arena)
+{
+    int64_t  *number = (int64_t *) ArenaAlloc(arena, sizeof(int64_t));
+    MEMCHECK( number );
+    *number = Nan::To<int32_t>(value).FromJust();
+    param->c_type = SQL_C_LONG;// SQL_C_SBIGINT;
+    if(!param->type || (param->type == 1)) 
+        param->type = SQL_BIGINT;
+    param->buffer = number;
+    param->length = sizeof(number);
+      
+    DEBUG_PRINTF("ODBC::GetInt32Param: param%u : paramtype=%u, c_type=%i, "
+                 "type=%i, size=%i, decimals=%i, buffer=%lld, buffer_length=%i, "
+                 "length=%i\n",
+                 num, param->paramtype, param->c_type, param->type, param->size,
+                 param->decimals, *number, param->buffer_length, param->length);
+}
+
+void ODBC::GetNumberParam(Local<Value> value, Parameter * param, int num, ParamArena* arena)
+{
+    double *number   = (double *) ArenaAlloc(arena, sizeof(double));
+    MEMCHECK( number );
+    *number = Nan::To<double>(value).FromJust();
+      
+    if(!param->c_type || (param->c_type == SQL_C_CHAR)) 
+        param->c_type    = SQL_C_DOUBLE;
+    if(!param->type || (param->type == SQL_CHAR)) 
+        param->type      = SQL_DECIMAL;
+    param->buffer        = number;
+    param->buffer_length = sizeof(double);
+    param->length        = param->buffer_length;
+    param->decimals      = 7;
+    param->size          = sizeof(double);
+
+    DEBUG_PRINTF("ODBC::GetNumberParam: param%u : paramtype=%u, c_type=%i, "
+                 "type=%i, size=%i, decimals=%i, buffer=%f, buffer_length=%i, "
+                 "length=%i\n",
+                 num, param->paramtype, param->c_type, param->type, param->size,
+                 param->decimals, *number, param->buffer_length, param->length);
+}
+
+void ODBC::GetBoolParam(Local<Value> value, Parameter * param, int num, ParamArena* arena)
+{
+    bool *boolean    = (bool *) ArenaAlloc(arena, sizeof(bool));
+    MEMCHECK( boolean );
+    *boolean = Nan::To<bool>(value).FromJust();
+    param->c_type = SQL_C_BIT;
+    if(!param->type || (param->type == SQL_CHAR)) 
+        param->type   = SQL_BIT;
+    param->buffer = boolean;
+    param->length = 0;
+      
+    DEBUG_PRINTF("ODBC::GetBoolParam: param%u : paramtype=%u, c_type=%i, "
+                 "type=%i, size=%i, decimals=%i, buffer_length=%i, length=%i\n",
+                 num, param->paramtype, param->c_type, param->type, param->size,
+                 param->decimals, param->buffer_length, param->length);
+}
+
+SQLRETURN ODBC::BindParameters(SQLHSTMT hSTMT, Parameter params[], int count, const char* changed)
+{
+    SQLRETURN ret = SQL_SUCCESS;
+    Parameter prm;
+
+    for (int i = 0; i < count; i++) 
+    {
+        //only the parameters UpdateParameters could not update in place
+        if (changed && !changed[i]) continue;
+
+        prm = params[i];
+
+        DEBUG_PRINTF(
+          "ODBC::BindParameters - param[%i]: c_type=%i type=%i "
+          "buffer_length=%i size=%i length=%i &length=%p\n", i, prm.c_type, prm.type,
+          prm.buffer_length, prm.size, prm.length, &params[i].length);
+
+        if(prm.paramtype == FILE_PARAM)  // FILE
+        {
+        /*    ret = SQLBindFileToParam (
+                      hSTMT,               // StatementHandle, 
+                      i + 1,               // TargetType, 
+                      prm.type,            // DataType, 
+                      (SQLCHAR *)prm.buffer,          // *FileName, 
+                      NULL,                // *FileNameLength, // NULL or SQL_NTS
+                      &params[i].fileOption,     // *FileOptions,  // SQL_FILE_READ = 2
+                      prm.decimals,        // MaxFileNameLength, 
+                      &params[i].fileIndicator); // *IndicatorValue); // 0 
+                      */
+        }
+        else
+            ret = SQLBindParameter(
+                      hSTMT,                    //StatementHandle
+                      i + 1,                    //ParameterNumber
+                      prm.paramtype,            //InputOutputType
+                      prm.c_type,               //ValueType
+                      prm.type,                 //ParameterType
+                      prm.size,                 //ColumnSize
+                      prm.decimals,             //DecimalDigits
+                      prm.buffer,               //ParameterValuePtr
+                      prm.buffer_length,        //BufferLength
+                      //using &prm.length did not work here...
+                      &params[i].length);       //StrLen_or_IndPtr
+
+        if (ret == SQL_ERROR) {break;}
+    }
+    return ret;
+}
+
+/*
+ * ParamValueSize
+ *
+ * The bytes of the value of a Parameter made by GetParametersFromArray, and
+ * so the room its buffer has for another value of the same types.
+ */
+
+static SQLLEN ParamValueSize(Parameter* prm)
+{
+  switch (prm->c_type) {
+    case SQL_C_LONG :
+      return sizeof(int64_t);
+    case SQL_C_BIT :
+      return sizeof(bool);
+    default :
+      return prm->buffer_length;
+  }
+}
+
+/*
+ * UpdateParameters
+ *
+ * Put the values of a new bind into params, the input parameters bound for
+ * the previous execution, without binding them again. A value of the same
+ * types that fits is copied into the bound buffer, and NULL only changes
+ * the indicator. Any other value gets a new buffer from arena, with room to
+ * grow for character and binary data, and is flagged in the array returned,
+ * which has one flag per parameter for BindParameters. The new values are
+ * converted into scratch, which is reset first.
+ *
+ * Returns NULL when the values have to be bound from scratch with
+ * GetParametersFromArray instead: their number changed, one of them is not
+ * an input parameter or is in the wrong format, or arena is over
+ * PARAM_ARENA_MAX_SIZE.
+ */
+
+char* ODBC::UpdateParameters(Local<Array> values, Parameter params[], int count,
+                             ParamArena* arena, ParamArena* scratch)
+{
+  DEBUG_PRINTF("ODBC::UpdateParameters count=%i\n", count);
+  int freshCount = 0;
+
+  if (count == 0 || (int) values->Length() != count ||
+      arena->allocated > PARAM_ARENA_MAX_SIZE) {
+    return NULL;
+  }
+
+  ResetParamArena(scratch);
+
+  //the bind from scratch throws any error again
+  Nan::TryCatch try_catch;
+  Parameter *fresh = GetParametersFromArray(values, &freshCount, scratch);
+  char *changed = (char *) ArenaAlloc(scratch, count);
+
+  if (try_catch.HasCaught() || !fresh || !changed || freshCount != count) {
+    return NULL;
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (params[i].paramtype != SQL_PARAM_INPUT || fresh[i].paramtype != SQL_PARAM_INPUT) {
+      return NULL;
+    }
+  }
+
+  for (int i = 0; i < count; i++) {
+    Parameter *prm = &params[i];
+    SQLLEN size = ParamValueSize(&fresh[i]);
+
+    changed[i] = 0;
+
+    if (fresh[i].length == SQL_NULL_DATA && fresh[i].buffer == NULL) {
+      prm->length = SQL_NULL_DATA;
+      continue;
+    }
+
+    if (prm->buffer != NULL &&
+        prm->c_type == fresh[i].c_type &&
+        prm->type == fresh[i].type &&
+        prm->decimals == fresh[i].decimals &&
+        size <= ParamValueSize(prm)) {
+      memcpy(prm->buffer, fresh[i].buffer, size);
+      prm->length = fresh[i].length;
+      continue;
+    }
+
+    SQLLEN capacity = size;
+    bool grows = fresh[i].c_type != SQL_C_LONG && fresh[i].c_type != SQL_C_DOUBLE &&
+                 fresh[i].c_type != SQL_C_BIT;
+
+    if (grows && prm->buffer != NULL && prm->c_type == fresh[i].c_type) {
+      capacity = size * 2;
+    }
+
+    void *buffer = ArenaAlloc(arena, capacity);
+
+    if (!buffer) {
+      return NULL;
+    }
+
+    memcpy(buffer, fresh[i].buffer, size);
+    *prm = fresh[i];
+    prm->buffer = buffer;
+
+    if (grows) {
+      prm->buffer_length = capacity;
+      prm->size = capacity;
+    }
+    changed[i] = 1;
+  }
+
+  return changed;
+}
+
+/*
+ * Kinds of the values of a parameter of executeBatch. A parameter with
+ * values of more than one kind is bound as character data, except for
+ * integers and other numbers, which are bound as doubles.
+ */
+
+enum { BATCH_NULL, BATCH_INT32, BATCH_NUMBER, BATCH_BOOL, BATCH_STRING, BATCH_INVALID };
+
+/*
+ * GetBatchKind
+ *
+ * The kind of value. width is raised to the bytes the value takes as
+ * character data, terminator included, when it is a string.
+ */
+
+static int GetBatchKind(Local<Value> value, SQLLEN* width)
+{
+  if (value->IsNull() || value->IsUndefined()) {
+    return BATCH_NULL;
+  }
+  else if (value->IsInt32()) {
+    return BATCH_INT32;
+  }
+  else if (value->IsNumber()) {
+    return BATCH_NUMBER;
+  }
+  else if (value->IsBoolean()) {
+    return BATCH_BOOL;
+  }
+  else if (value->IsString()) {
+    Local<String> string = Local<String>::Cast(value);
+    SQLLEN length;
+#ifdef UNICODE
+    length = (string->Length() + 1) * sizeof(uint16_t);
+#else
+    length = string->Utf8Length( ISOLATE ) + 1;
+#endif
+    if (length > *width) {
+      *width = length;
+    }
+    return BATCH_STRING;
+  }
+  return BATCH_INVALID;
+}
+
+static int MergeBatchKinds(int kind, int other, bool* mixed)
+{
+  if (kind == BATCH_NULL || kind == other) {
+    return other;
+  }
+  if (other == BATCH_NULL) {
+    return kind;
+  }
+  if ((kind == BATCH_INT32 && other == BATCH_NUMBER) ||
+      (kind == BATCH_NUMBER && other == BATCH_INT32)) {
+    return BATCH_NUMBER;
+  }
+  *mixed = true;
+  return BATCH_STRING;
+}
+
+/*
+ * SetBatchArrayType
+ *
+ * The types of array for values of kind, and the width of one of them;
+ * character data takes width bytes, with room for numbers and booleans
+ * turned into strings when they are mixed in.
+ */
+
+static void SetBatchArrayType(ParameterArray* array, int kind, bool mixed, SQLLEN width)
+{
+  array->decimals = 0;
+  array->size = 0;
+
+  switch (kind) {
+    case BATCH_INT32 :
+      array->c_type = SQL_C_LONG;
+      array->type = SQL_INTEGER;
+      array->width = sizeof(SQLINTEGER);
+      break;
+    case BATCH_NUMBER :
+      array->c_type = SQL_C_DOUBLE;
+      array->type = SQL_DOUBLE;
+      array->width = sizeof(double);
+      break;
+    case BATCH_BOOL :
+      array->c_type = SQL_C_BIT;
+      array->type = SQL_BIT;
+      array->width = sizeof(SQLCHAR);
+      break;
+    default :
+      if (mixed && width < 32 * (SQLLEN) sizeof(SQLTCHAR)) {
+        width = 32 * sizeof(SQLTCHAR);
+      }
+      if (width < (SQLLEN) sizeof(SQLTCHAR)) {
+        width = sizeof(SQLTCHAR);
+      }
+      array->c_type = SQL_C_TCHAR;
+      array->width = width;
+      array->size = width / sizeof(SQLTCHAR) - 1;
+      if (array->size == 0) {
+        array->size = 1;
+      }
+#ifdef UNICODE
+      array->type = (array->size >= 8000) ? SQL_WLONGVARCHAR : SQL_WVARCHAR;
+#else
+      array->type = (array->size >= 8000) ? SQL_LONGVARCHAR : SQL_VARCHAR;
+#endif
+      break;
+  }
+}
+
+/*
+ * SetBatchValue
+ *
+ * Store value, of a parameter of kind, in row of array.
+ */
+
+static void SetBatchValue(ParameterArray* array, int kind, SQLULEN row, Local<Value> value)
+{
+  char *element = array->buffer + row * array->width;
+
+  if (value->IsNull() || value->IsUndefined()) {
+    array->indicators[row] = SQL_NULL_DATA;
+    return;
+  }
+
+  switch (kind) {
+    case BATCH_INT32 :
+      *(SQLINTEGER *) element = Nan::To<int32_t>(value).FromJust();
+      array->indicators[row] = sizeof(SQLINTEGER);
+      break;
+    case BATCH_NUMBER :
+      *(double *) element = Nan::To<double>(value).FromJust();
+      array->indicators[row] = sizeof(double);
+      break;
+    case BATCH_BOOL :
+      *(SQLCHAR *) element = Nan::To<bool>(value).FromJust() ? 1 : 0;
+      array->indicators[row] = sizeof(SQLCHAR);
+      break;
+    default : {
+      Local<String> string = value->TOSTRING;
+#ifdef UNICODE
+      string->Write( ISOLATECOMMA (uint16_t *) element, 0, array->width / sizeof(uint16_t) );
+#else
+      string->WriteUtf8( ISOLATECOMMA element, array->width );
+#endif
+      array->indicators[row] = SQL_NTS;
+      break;
+    }
+  }
+}
+
+/*
+ * GetParameterArrays
+ *
+ * Convert rows, an Array of Arrays with one value per parameter, to one
+ * ParameterArray per parameter for BindParameterArrays. A parameter takes the
+ * type of its values: integers are bound as SQL_C_LONG, other numbers as
+ * SQL_C_DOUBLE, booleans as SQL_C_BIT and strings as character data as wide
+ * as the longest one. The arrays and all the values are in one allocation,
+ * released with free(). Throws and returns NULL when a row is not an Array
+ * of as many values as the first one.
+ */
+
+ParameterArray* ODBC::GetParameterArrays(Local<Array> rows, int* paramCount, SQLULEN* rowCount)
+{
+  DEBUG_PRINTF("ODBC::GetParameterArrays\n");
+
+  *rowCount = rows->Length();
+  *paramCount = 0;
+
+  if (*rowCount > 0) {
+    Local<Value> first = Nan::Get(rows, 0).ToLocalChecked();
+
+    if (first->IsArray()) {
+      *paramCount = Local<Array>::Cast(first)->Length();
+    }
+  }
+
+  if (*paramCount == 0) {
+    Nan::ThrowTypeError("executeBatch needs an Array of rows, each one an Array of parameter values");
+    return NULL;
+  }
+
+  int *kinds = new int[*paramCount];
+  bool *mixed = new bool[*paramCount];
+  SQLLEN *widths = new SQLLEN[*paramCount];
+
+  for (int j = 0; j < *paramCount; j++) {
+    kinds[j] = BATCH_NULL;
+    mixed[j] = false;
+    widths[j] = 0;
+  }
+
+  //first pass: the kind of every parameter and the width of its strings
+  for (SQLULEN i = 0; i < *rowCount; i++) {
+    Local<Value> row = Nan::Get(rows, i).ToLocalChecked();
+
+    if (!row->IsArray() || Local<Array>::Cast(row)->Length() != (uint32_t) *paramCount) {
+      delete [] kinds;
+      delete [] mixed;
+      delete [] widths;
+      Nan::ThrowTypeError("Every row of executeBatch must be an Array with one value per parameter");
+      return NULL;
+    }
+
+    for (int j = 0; j < *paramCount; j++) {
+      int kind = GetBatchKind(Nan::Get(Local<Array>::Cast(row), j).ToLocalChecked(), &widths[j]);
+
+      if (kind == BATCH_INVALID) {
+        delete [] kinds;
+        delete [] mixed;
+        delete [] widths;
+        Nan::ThrowTypeError("The values of executeBatch must be strings, numbers, booleans or null");
+        return NULL;
+      }
+      kinds[j] = MergeBatchKinds(kinds[j], kind, &mixed[j]);
+    }
+  }
+
+  size_t header = (*paramCount * sizeof(ParameterArray) + 7) & ~7;
+  size_t length = header;
+  ParameterArray *types = new ParameterArray[*paramCount];
+
+  for (int j = 0; j < *paramCount; j++) {
+    SetBatchArrayType(&types[j], kinds[j], mixed[j], widths[j]);
+    length += *rowCount * sizeof(SQLLEN) + ((*rowCount * types[j].width + 7) & ~7);
+  }
+
+  char *block = (char *) malloc(length);
+
+  if (!block) {
+    delete [] kinds;
+    delete [] mixed;
+    delete [] widths;
+    delete [] types;
+    Nan::LowMemoryNotification();
+    Nan::ThrowError("Could not allocate enough memory for params in ODBC::GetParameterArrays.");
+    return NULL;
+  }
+
+  ParameterArray *arrays = (ParameterArray *) block;
+  char *next = block + header;
+
+  for (int j = 0; j < *paramCount; j++) {
+    arrays[j] = types[j];
+    arrays[j].indicators = (SQLLEN *) next;
+    next += *rowCount * sizeof(SQLLEN);
+    arrays[j].buffer = next;
+    next += (*rowCount * arrays[j].width + 7) & ~7;
+  }
+
+  //second pass: the values
+  for (SQLULEN i = 0; i < *rowCount; i++) {
+    Local<Array> row = Local<Array>::Cast(Nan::Get(rows, i).ToLocalChecked());
+
+    for (int j = 0; j < *paramCount; j++) {
+      SetBatchValue(&arrays[j], kinds[j], i, Nan::Get(row, j).ToLocalChecked());
+    }
+  }
+
+  delete [] kinds;
+  delete [] mixed;
+  delete [] widths;
+  delete [] types;
+
+  return arrays;
+}
+
+/*
+ * IsBinaryType
+ *
+ * True for the SQL types of the columns of FETCH_COLUMNAR whose values and
+ * offsets hold binary data rather than characters.
+ */
+
+static bool IsBinaryType(Local<Value> type)
+{
+  if (!type->IsNumber()) {
+    return false;
+  }
+
+  switch (Nan::To<int32_t>(type).FromJust()) {
+    case SQL_BINARY :
+    case SQL_VARBINARY :
+    case SQL_LONGVARBINARY :
+      return true;
+    default :
+      return false;
+  }
+}
+
+/*
+ * GetColumnParameterArrays
+ *
+ * Like GetParameterArrays, for the values given column by column: each
+ * column is an Int32Array, Float64Array, BigInt64Array or Uint8Array, bound
+ * as INTEGER, FLOAT, BIGINT or BIT, an Array of values, or an object with
+ * such values and a nulls bitmap. An object can also have a Buffer of
+ * values and an Int32Array of rowCount + 1 offsets, where the value of row n
+ * is the bytes from offsets[n] to offsets[n + 1], character data unless its
+ * type is a binary SQL type. These are the shapes of the columns of
+ * FETCH_COLUMNAR. Bit n of nulls is set when the value of row n is NULL.
+ * With inPlace the memory of a typed array is bound as it is, without a
+ * copy, which is only safe while no JavaScript runs before the execution is
+ * over; everything else is copied to the allocation released with free().
+ * Throws and returns NULL when the columns are not all of the same length.
+ */
+
+ParameterArray* ODBC::GetColumnParameterArrays(Local<Array> columns, int* paramCount, SQLULEN* rowCount,
+                                               bool inPlace)
+{
+  DEBUG_PRINTF("ODBC::GetColumnParameterArrays\n");
+  Local<String> valuesKey = Nan::New("values").ToLocalChecked();
+  Local<String> nullsKey = Nan::New("nulls").ToLocalChecked();
+  Local<String> offsetsKey = Nan::New("offsets").ToLocalChecked();
+  Local<String> typeKey = Nan::New("type").ToLocalChecked();
+  const char *error = NULL;
+#ifdef UNICODE
+  SQLLEN terCharLen = 2;
+#else
+  SQLLEN terCharLen = 1;
+#endif
+
+  *paramCount = columns->Length();
+  *rowCount = 0;
+
+  if (*paramCount == 0) {
+    Nan::ThrowTypeError("executeBatch needs an Array of columns");
+    return NULL;
+  }
 
-      val = Nan::Get(paramArray, 0).ToLocalChecked();
-      if(val->IsInt32())
-          params[i].paramtype = Nan::To<int32_t>(val).FromJust();
+  int *kinds = new int[*paramCount];
+  bool *mixed = new bool[*paramCount];
+  uint8_t **nulls = new uint8_t*[*paramCount];
+  char **sources = new char*[*paramCount];
+  int32_t **offsets = new int32_t*[*paramCount];
+  ParameterArray *types = new ParameterArray[*paramCount];
 
-      val = Nan::Get(paramArray, 1).ToLocalChecked();
-      if(val->IsInt32())
-          params[i].c_type = Nan::To<int32_t>(val).FromJust();
-      else
-          params[i].c_type = SQL_C_CHAR;
+  size_t header = (*paramCount * sizeof(ParameterArray) + 7) & ~7;
+  size_t length = header;
 
-      val = Nan::Get(paramArray, 2).ToLocalChecked();
-      if(val->IsInt32())
-          params[i].type = Nan::To<int32_t>(val).FromJust();
-      else
-          params[i].type = SQL_CHAR;
+  //first pass: the type and length of every column
+  for (int j = 0; j < *paramCount && !error; j++) {
+    Local<Value> column = Nan::Get(columns, j).ToLocalChecked();
+    Local<Value> values = column;
+    Local<Value> offsetArray = Nan::Undefined();
+    Local<Value> type = Nan::Undefined();
+    SQLULEN count = 0;
+    SQLULEN valueCount = 0;
 
-      if(arrlen == 5)
-      {
-          val = Nan::Get(paramArray, 4).ToLocalChecked();
-          if(val->IsInt32())
-              params[i].buffer_length = Nan::To<int32_t>(val).FromJust();
-      }
+    kinds[j] = BATCH_INVALID;
+    mixed[j] = false;
+    nulls[j] = NULL;
+    sources[j] = NULL;
+    offsets[j] = NULL;
 
-      val = Nan::Get(paramArray, 3).ToLocalChecked();
-      if (val->IsNull()) {
-          GetNullParam(&params[i], i+1);
+    if (column->IsObject() && !column->IsArray() && !column->IsArrayBufferView()) {
+      Local<Object> object = Nan::To<Object>(column).ToLocalChecked();
+      Local<Value> bitmap = Nan::Get(object, nullsKey).ToLocalChecked();
+
+      values = Nan::Get(object, valuesKey).ToLocalChecked();
+      offsetArray = Nan::Get(object, offsetsKey).ToLocalChecked();
+      type = Nan::Get(object, typeKey).ToLocalChecked();
+
+      if (bitmap->IsArrayBufferView()) {
+        Nan::TypedArrayContents<uint8_t> bits(bitmap);
+        nulls[j] = *bits;
+        count = bits.length() * 8;
       }
-      else if (val->IsInt32()) {
-          GetInt32Param(val, &params[i], i+1);
+      else if (!bitmap->IsNull() && !bitmap->IsUndefined()) {
+        error = "The nulls of a column of executeBatch must be a Buffer or a Uint8Array";
+        break;
       }
-      else if (val->IsNumber()) {
-          GetNumberParam(val, &params[i], i+1);
+    }
+
+    types[j].decimals = 0;
+    types[j].size = 0;
+
+    if (offsetArray->IsInt32Array() && values->IsArrayBufferView()) {
+      Nan::TypedArrayContents<int32_t> bounds(offsetArray);
+      Nan::TypedArrayContents<char> data(values);
+      SQLLEN longest = 0;
+
+      valueCount = bounds.length() > 0 ? bounds.length() - 1 : 0;
+      offsets[j] = *bounds;
+      sources[j] = *data;
+
+      for (SQLULEN i = 0; i < valueCount && !error; i++) {
+        if (offsets[j][i] < 0 || offsets[j][i] > offsets[j][i + 1] || offsets[j][i + 1] > (int32_t) data.length()) {
+          error = "The offsets of a column of executeBatch must be in order and within its values";
+        }
+        else if (offsets[j][i + 1] - offsets[j][i] > longest) {
+          longest = offsets[j][i + 1] - offsets[j][i];
+        }
       }
-      else if (val->IsBoolean()) {
-          GetBoolParam(val, &params[i], i+1);
+
+      if (IsBinaryType(type)) {
+        types[j].c_type = SQL_C_BINARY;
+        types[j].type = SQL_LONGVARBINARY;
+        types[j].width = longest > 0 ? longest : 1;
+        types[j].size = types[j].width;
       }
-      else
-      {
-          GetStringParam(val, &params[i], i+1);
+      else {
+        SetBatchArrayType(&types[j], BATCH_STRING, false, longest + terCharLen);
       }
+      kinds[j] = BATCH_STRING;
     }
-    else if (value->IsString()) {
-        GetStringParam(value, &params[i], i+1);
+    else if (!offsetArray->IsUndefined() && !offsetArray->IsNull()) {
+      error = "The offsets of a column of executeBatch must be an Int32Array with a Buffer of values";
     }
-    else if (value->IsNull()) {
-        GetNullParam(&params[i], i+1);
+    else if (values->IsInt32Array()) {
+      Nan::TypedArrayContents<int32_t> contents(values);
+      types[j].c_type = SQL_C_SLONG;
+      types[j].type = SQL_INTEGER;
+      types[j].width = sizeof(int32_t);
+      sources[j] = (char *) *contents;
+      valueCount = contents.length();
+      kinds[j] = BATCH_NULL;
     }
-    else if (value->IsInt32()) {
-        GetInt32Param(value, &params[i], i+1);
+    else if (values->IsFloat64Array()) {
+      Nan::TypedArrayContents<double> contents(values);
+      types[j].c_type = SQL_C_DOUBLE;
+      types[j].type = SQL_DOUBLE;
+      types[j].width = sizeof(double);
+      sources[j] = (char *) *contents;
+      valueCount = contents.length();
+      kinds[j] = BATCH_NULL;
     }
-    else if (value->IsNumber()) {
-        GetNumberParam(value, &params[i], i+1);
+    else if (values->IsBigInt64Array()) {
+      Nan::TypedArrayContents<int64_t> contents(values);
+      types[j].c_type = SQL_C_SBIGINT;
+      types[j].type = SQL_BIGINT;
+      types[j].width = sizeof(int64_t);
+      sources[j] = (char *) *contents;
+      valueCount = contents.length();
+      kinds[j] = BATCH_NULL;
     }
-    else if (value->IsBoolean()) {
-        GetBoolParam(value, &params[i], i+1);
+    else if (values->IsUint8Array()) {
+      //one byte per row, 0 or 1, as FETCH_COLUMNAR returns BIT columns
+      Nan::TypedArrayContents<uint8_t> contents(values);
+      types[j].c_type = SQL_C_BIT;
+      types[j].type = SQL_BIT;
+      types[j].width = sizeof(uint8_t);
+      sources[j] = (char *) *contents;
+      valueCount = contents.length();
+      kinds[j] = BATCH_NULL;
     }
-  } 
-  return params;
-}
+    else if (values->IsArray()) {
+      Local<Array> array = Local<Array>::Cast(values);
+      SQLLEN width = 0;
 
-void ODBC::GetStringParam(Local<Value> value, Parameter * param, int num)
-{
-    Local<String> string = value->TOSTRING;
-    int length = string->Length();
-    int bufflen = 0;
-      
-    param->length        = SQL_NTS;
-    if(!param->c_type || (param->c_type == SQL_CHAR))
-        param->c_type = SQL_C_TCHAR;
-    #ifdef UNICODE
-    if(!param->type || (param->type == SQL_CHAR))
-        param->type = (length >= 8000) ? SQL_WLONGVARCHAR : SQL_WVARCHAR;
-    if(param->c_type != SQL_C_BINARY)
-        bufflen = (length * sizeof(uint16_t)) + sizeof(uint16_t);
-    #else
-    if(!param->type || (param->type == SQL_CHAR))
-        param->type = (length >= 8000) ? SQL_LONGVARCHAR : SQL_VARCHAR;
-    if(param->c_type != SQL_C_BINARY)
-        bufflen = string->Utf8Length( ISOLATE ) + 1;
-    #endif
-    if(bufflen < param->buffer_length && (param->paramtype % 2 == 0))
-        bufflen = param->buffer_length;
-    param->buffer_length = bufflen;
+      kinds[j] = BATCH_NULL;
+      for (uint32_t i = 0; i < array->Length(); i++) {
+        int kind = GetBatchKind(Nan::Get(array, i).ToLocalChecked(), &width);
 
-    if(param->c_type == SQL_C_BINARY || param->paramtype == FILE_PARAM)
-    {
-        param->buffer_length = length + 1; //null terminator added by WriteOneByte
-        param->length        = length; 
+        if (kind == BATCH_INVALID) {
+          error = "The values of executeBatch must be strings, numbers, booleans or null";
+          break;
+        }
+        kinds[j] = MergeBatchKinds(kinds[j], kind, &mixed[j]);
+      }
+      SetBatchArrayType(&types[j], kinds[j], mixed[j], width);
+      valueCount = array->Length();
+    }
+    else {
+      error = "A column of executeBatch must be an Int32Array, a Float64Array, a BigInt64Array, "
+              "a Uint8Array, an Array or values with offsets";
     }
-    param->size          = param->buffer_length;
-    param->buffer        = malloc(param->buffer_length);
-    MEMCHECK( param->buffer );
 
-    if(param->paramtype == FILE_PARAM)
-        string->WriteUtf8( ISOLATECOMMA (char *) param->buffer );
-    else if(param->c_type == SQL_C_BINARY)
-    {
-#if (NODE_MODULE_VERSION < NODE_0_12_MODULE_VERSION)
-        memcpy(param->buffer, &string, param->buffer_length);
-        //param->buffer = &string;
-#else
-        string->WriteOneByte( ISOLATECOMMA (uint8_t *)param->buffer );
-#endif
+    if (error) {
+      break;
     }
-    else
-    {
-        #ifdef UNICODE
-        string->Write( ISOLATECOMMA (uint16_t *) param->buffer );
-        #else
-        string->WriteUtf8( ISOLATECOMMA (char *) param->buffer );
-        #endif
+
+    if (j == 0) {
+      *rowCount = valueCount;
+    }
+    if (valueCount != *rowCount || (nulls[j] && count < *rowCount)) {
+      error = "The columns of executeBatch must all have as many values";
+      break;
     }
 
-    if(param->paramtype == FILE_PARAM)  // For SQLBindFileToParam()
-    {
-    /*
-       SQLRETURN SQLBindFileToParam (
-                 SQLHSTMT          StatementHandle,   // hstmt 
-                 SQLUSMALLINT      TargetType,        // i 
-                 SQLSMALLINT       DataType,          // type 
-                 SQLCHAR           *FileName,         // buffer
-                 SQLSMALLINT       *FileNameLength,   // NULL
-                 SQLUINTEGER       *FileOptions,      // SQL_FILE_READ = 2 -> fileOption
-                 SQLSMALLINT       MaxFileNameLength, // buffer_length -> decimals
-                 SQLINTEGER        *IndicatorValue);  // 0 -> fileIndicator
-    */
-        param->decimals = param->buffer_length;
-     //   param->fileOption = SQL_FILE_READ;
-        param->fileIndicator = 0;
+    if (sources[j] && !offsets[j] && inPlace) {
+      //bound in place; indicators only for NULLs
+      if (nulls[j]) {
+        length += *rowCount * sizeof(SQLLEN);
+      }
+    }
+    else {
+      length += *rowCount * sizeof(SQLLEN) + ((*rowCount * types[j].width + 7) & ~7);
     }
+  }
 
-    DEBUG_PRINTF("ODBC::GetStringParam: param%u : paramtype=%u, c_type=%i, "
-                 "type=%i, size=%i, decimals=%i, buffer=%s, buffer_length=%i, "
-                 "length=%i\n", num, param->paramtype, param->c_type, 
-                 param->type, param->size, param->decimals, 
-                 (char *)param->buffer, param->buffer_length, param->length);
-}
+  if (!error && *rowCount == 0) {
+    error = "executeBatch needs at least one row";
+  }
 
-void ODBC::GetNullParam(Parameter * param, int num)
-{
-    param->c_type = SQL_C_DEFAULT;
-    param->type   = SQL_VARCHAR;
-    param->length = SQL_NULL_DATA;
+  char *block = error ? NULL : (char *) malloc(length);
 
-    DEBUG_PRINTF("ODBC::GetNullParam: param%u : paramtype=%u, c_type=%i, "
-                 "type=%i, size=%i, decimals=%i, buffer_length=%i, length=%i\n",
-                 num, param->paramtype, param->c_type, param->type, param->size,
-                 param->decimals, param->buffer_length, param->length);
-}
+  if (!block) {
+    delete [] kinds;
+    delete [] mixed;
+    delete [] nulls;
+    delete [] sources;
+    delete [] offsets;
+    delete [] types;
+    if (error) {
+      Nan::ThrowTypeError(error);
+    }
+    else {
+      Nan::LowMemoryNotification();
+      Nan::ThrowError("Could not allocate enough memory for params in ODBC::GetColumnParameterArrays.");
+    }
+    return NULL;
+  }
 
-void ODBC::GetInt32Param(Local<Value> value, Parameter * param, int num)
-{
-    int64_t  *number = new int64_t(Nan::To<int32_t>(value).FromJust());
-    param->c_type = SQL_C_LONG;// SQL_C_SBIGINT;
-    if(!param->type || (param->type == 1)) 
-        param->type = SQL_BIGINT;
-    param->buffer = number;
-    param->length = sizeof(number);
-      
-    DEBUG_PRINTF("ODBC::GetInt32Param: param%u : paramtype=%u, c_type=%i, "
-                 "type=%i, size=%i, decimals=%i, buffer=%lld, buffer_length=%i, "
-                 "length=%i\n",
-                 num, param->paramtype, param->c_type, param->type, param->size,
-                 param->decimals, *number, param->buffer_length, param->length);
-}
+  ParameterArray *arrays = (ParameterArray *) block;
+  char *next = block + header;
 
-void ODBC::GetNumberParam(Local<Value> value, Parameter * param, int num)
-{
-    double *number   = new double(Nan::To<double>(value).FromJust());
-      
-    if(!param->c_type || (param->c_type == SQL_C_CHAR)) 
-        param->c_type    = SQL_C_DOUBLE;
-    if(!param->type || (param->type == SQL_CHAR)) 
-        param->type      = SQL_DECIMAL;
-    param->buffer        = number;
-    param->buffer_length = sizeof(double);
-    param->length        = param->buffer_length;
-    param->decimals      = 7;
-    param->size          = sizeof(double);
+  //second pass: the indicators, and the values that are not bound in place
+  for (int j = 0; j < *paramCount; j++) {
+    arrays[j] = types[j];
+    arrays[j].buffer = NULL;
+    arrays[j].indicators = NULL;
 
-    DEBUG_PRINTF("ODBC::GetNumberParam: param%u : paramtype=%u, c_type=%i, "
-                 "type=%i, size=%i, decimals=%i, buffer=%f, buffer_length=%i, "
-                 "length=%i\n",
-                 num, param->paramtype, param->c_type, param->type, param->size,
-                 param->decimals, *number, param->buffer_length, param->length);
-}
+    if (sources[j] && !offsets[j] && inPlace) {
+      arrays[j].buffer = sources[j];
+    }
+    else {
+      arrays[j].indicators = (SQLLEN *) next;
+      next += *rowCount * sizeof(SQLLEN);
+      arrays[j].buffer = next;
+      next += (*rowCount * arrays[j].width + 7) & ~7;
+    }
 
-void ODBC::GetBoolParam(Local<Value> value, Parameter * param, int num)
-{
-    bool *boolean    = new bool(Nan::To<bool>(value).FromJust());
-    param->c_type = SQL_C_BIT;
-    if(!param->type || (param->type == SQL_CHAR)) 
-        param->type   = SQL_BIT;
-    param->buffer = boolean;
-    param->length = 0;
-      
-    DEBUG_PRINTF("ODBC::GetBoolParam: param%u : paramtype=%u, c_type=%i, "
-                 "type=%i, size=%i, decimals=%i, buffer_length=%i, length=%i\n",
-                 num, param->paramtype, param->c_type, param->type, param->size,
-                 param->decimals, param->buffer_length, param->length);
+    if (offsets[j]) {
+      for (SQLULEN i = 0; i < *rowCount; i++) {
+        SQLLEN len = offsets[j][i + 1] - offsets[j][i];
+
+        memcpy(arrays[j].buffer + i * arrays[j].width, sources[j] + offsets[j][i], len);
+        arrays[j].indicators[i] = len;
+      }
+    }
+    else if (sources[j]) {
+      if (arrays[j].buffer != sources[j]) {
+        memcpy(arrays[j].buffer, sources[j], *rowCount * arrays[j].width);
+
+        for (SQLULEN i = 0; i < *rowCount; i++) {
+          arrays[j].indicators[i] = arrays[j].width;
+        }
+      }
+      else if (nulls[j]) {
+        arrays[j].indicators = (SQLLEN *) next;
+        next += *rowCount * sizeof(SQLLEN);
+
+        for (SQLULEN i = 0; i < *rowCount; i++) {
+          arrays[j].indicators[i] = arrays[j].width;
+        }
+      }
+    }
+    else {
+      Local<Value> column = Nan::Get(columns, j).ToLocalChecked();
+      Local<Array> values = Local<Array>::Cast(column->IsArray()
+        ? column
+        : Nan::Get(Nan::To<Object>(column).ToLocalChecked(), valuesKey).ToLocalChecked());
+
+      for (SQLULEN i = 0; i < *rowCount; i++) {
+        SetBatchValue(&arrays[j], kinds[j], i, Nan::Get(values, i).ToLocalChecked());
+      }
+    }
+
+    if (nulls[j]) {
+      for (SQLULEN i = 0; i < *rowCount; i++) {
+        if (nulls[j][i >> 3] & (1 << (i & 7))) {
+          arrays[j].indicators[i] = SQL_NULL_DATA;
+        }
+      }
+    }
+  }
+
+  delete [] kinds;
+  delete [] mixed;
+  delete [] nulls;
+  delete [] sources;
+  delete [] offsets;
+  delete [] types;
+
+  return arrays;
 }
 
-SQLRETURN ODBC::BindParameters(SQLHSTMT hSTMT, Parameter params[], int count)
+/*
+ * BindParameterArrays
+ *
+ * Bind the ParameterArrays of rowCount rows so that one SQLExecute runs the
+ * statement for all of them. SQLExecute stores the outcome of every row in
+ * status and the number of rows it went through in processed. The statement
+ * has to be put back with ResetParameterArrays before the arrays are freed.
+ */
+
+SQLRETURN ODBC::BindParameterArrays(SQLHSTMT hSTMT, ParameterArray arrays[], int count, SQLULEN rowCount,
+                                    SQLUSMALLINT* status, SQLULEN* processed)
 {
-    SQLRETURN ret = SQL_SUCCESS;
-    Parameter prm;
+  DEBUG_PRINTF("ODBC::BindParameterArrays count=%i rowCount=%i\n", count, rowCount);
+  SQLRETURN ret;
 
-    for (int i = 0; i < count; i++) 
-    {
-        prm = params[i];
+  ret = SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAM_BIND_TYPE, (SQLPOINTER) SQL_PARAM_BIND_BY_COLUMN, 0);
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) (intptr_t) rowCount, 0);
+  }
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAM_STATUS_PTR, status, 0);
+  }
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAMS_PROCESSED_PTR, processed, 0);
+  }
 
-        DEBUG_PRINTF(
-          "ODBC::BindParameters - param[%i]: c_type=%i type=%i "
-          "buffer_length=%i size=%i length=%i &length=%p\n", i, prm.c_type, prm.type,
-          prm.buffer_length, prm.size, prm.length, &params[i].length);
+  for (int i = 0; i < count && SQL_SUCCEEDED(ret); i++) {
+    ret = SQLBindParameter(
+              hSTMT,                    //StatementHandle
+              i + 1,                    //ParameterNumber
+              SQL_PARAM_INPUT,          //InputOutputType
+              arrays[i].c_type,         //ValueType
+              arrays[i].type,           //ParameterType
+              arrays[i].size,           //ColumnSize
+              arrays[i].decimals,       //DecimalDigits
+              arrays[i].buffer,         //ParameterValuePtr
+              arrays[i].width,          //BufferLength
+              arrays[i].indicators);    //StrLen_or_IndPtr
+  }
+  return ret;
+}
 
-        if(prm.paramtype == FILE_PARAM)  // FILE
-        {
-        /*    ret = SQLBindFileToParam (
-                      hSTMT,               // StatementHandle, 
-                      i + 1,               // TargetType, 
-                      prm.type,            // DataType, 
-                      (SQLCHAR *)prm.buffer,          // *FileName, 
-                      NULL,                // *FileNameLength, // NULL or SQL_NTS
-                      &params[i].fileOption,     // *FileOptions,  // SQL_FILE_READ = 2
-                      prm.decimals,        // MaxFileNameLength, 
-                      &params[i].fileIndicator); // *IndicatorValue); // 0 
-                      */
-        }
-        else
-            ret = SQLBindParameter(
-                      hSTMT,                    //StatementHandle
-                      i + 1,                    //ParameterNumber
-                      prm.paramtype,            //InputOutputType
-                      prm.c_type,               //ValueType
-                      prm.type,                 //ParameterType
-                      prm.size,                 //ColumnSize
-                      prm.decimals,             //DecimalDigits
-                      prm.buffer,               //ParameterValuePtr
-                      prm.buffer_length,        //BufferLength
-                      //using &prm.length did not work here...
-                      &params[i].length);       //StrLen_or_IndPtr
+/*
+ * ResetParameterArrays
+ *
+ * Unbind the arrays bound by BindParameterArrays and go back to a single set
+ * of parameters, which have to be bound again before the next execute.
+ */
 
-        if (ret == SQL_ERROR) {break;}
-    }
-    return ret;
+void ODBC::ResetParameterArrays(SQLHSTMT hSTMT)
+{
+  SQLFreeStmt(hSTMT, SQL_RESET_PARAMS);
+  SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAMSET_SIZE, (SQLPOINTER) 1, 0);
+  SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAM_STATUS_PTR, NULL, 0);
+  SQLSetStmtAttr(hSTMT, SQL_ATTR_PARAMS_PROCESSED_PTR, NULL, 0);
 }
 
 /*
@@ -1199,8 +4992,7 @@ Local<Value> ODBC::GetSQLError (SQLSMALLINT handleType, SQLHANDLE handle, char*
 Local<Array> ODBC::GetAllRecordsSync (SQLHENV hENV, 
                                      SQLHDBC hDBC, 
                                      SQLHSTMT hSTMT,
-                                     uint16_t* buffer,
-                                     int bufferLength) {
+                                     ScratchBuffer* scratch) {
   DEBUG_PRINTF("ODBC::GetAllRecordsSync\n");
   
   Nan::EscapableHandleScope scope;
@@ -1212,6 +5004,8 @@ Local<Array> ODBC::GetAllRecordsSync (SQLHENV hENV,
   short colCount = 0;
   
   Column* columns = GetColumns(hSTMT, &colCount);
+  Nan::Persistent<String>* names = GetColumnNames(columns, colCount);
+  Local<ObjectTemplate> rowTemplate = GetRowTemplate(names, colCount);
   
   Local<Array> rows = Nan::New<Array>();
   
@@ -1237,8 +5031,6 @@ Local<Array> ODBC::GetAllRecordsSync (SQLHENV hENV,
     
     //check to see if we are at the end of the recordset
     if (ret == SQL_NO_DATA) {
-      ODBC::FreeColumns(columns, &colCount);
-      
       break;
     }
 
@@ -1248,12 +5040,17 @@ Local<Array> ODBC::GetAllRecordsSync (SQLHENV hENV,
         hSTMT,
         columns,
         &colCount,
-        buffer,
-        bufferLength)
+        scratch,
+        names,
+        rowTemplate)
     );
 
     count++;
   }
+  
+  ODBC::FreeColumnNames(names, colCount);
+  ODBC::FreeColumns(columns, &colCount);
+  
   //TODO: what do we do about errors!?!
   //we throw them
   return scope.Escape(rows);
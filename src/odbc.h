@@ -34,10 +34,68 @@ using namespace node;
 #define MAX_FIELD_SIZE 1024
 #define MAX_VALUE_SIZE 1022
 
+// Rowset (block) fetching: columns wider than MAX_BOUND_COLUMN_SIZE bytes are
+// not bound and force the row at a time path, and the bound arrays of one
+// rowset never take more than MAX_ROWSET_BUFFER_SIZE bytes.
+#define MAX_BOUND_COLUMN_SIZE 32768
+#define MAX_ROWSET_BUFFER_SIZE (16 * 1024 * 1024)
+#define MAX_ROWSET_SIZE 65535
+#define MAX_COLUMN_VECTOR_SIZE 0x7fffffff
+#define COLUMN_VECTOR_INITIAL_ROWS 1024
+#define LOB_CHUNK_SIZE 65536
+// Longer values grow the buffer they are read into; up to
+// MAX_BUFFER_SIZE bytes are kept for the next rows of the result set.
+#define MAX_BUFFER_SIZE (1024 * 1024)
+#define MAX_GROWN_BUFFER_SIZE 0x3fffffff
+#define EXPORT_BLOCK_SIZE (1024 * 1024)
+#define EXPORT_MEMORY_ERROR "[node-informixdb] Could not allocate enough memory to format the exported rows."
+#define COLUMNAR_MEMORY_ERROR "[node-informixdb] Could not allocate enough memory for the FETCH_COLUMNAR result."
+#ifdef UNICODE
+#define MAX_CHAR_BYTES 2
+#else
+#define MAX_CHAR_BYTES 4
+#endif
+
 #define MODE_COLLECT_AND_CALLBACK 1
 #define MODE_CALLBACK_FOR_EACH 2
 #define FETCH_ARRAY 3
 #define FETCH_OBJECT 4
+#define FETCH_COLUMNAR 5
+#define FETCH_LAZY 6
+
+// Most lists of column names that get a row template of their own
+#define TEMPLATE_CACHE_SIZE 256
+
+// Rowset size of fetchAll in FETCH_LAZY mode when no rowsetSize is set
+#define LAZY_ROWSET_SIZE 256
+
+// Slots of the string dictionary of each column of a result, a power of 2,
+// and the longest value in bytes it keeps
+#define DICTIONARY_SIZE 512
+#define DICTIONARY_KEY_SIZE 64
+
+// First block of the arena of bound parameters, and the most a statement
+// keeps of it from one execution to the next
+#define PARAM_ARENA_BLOCK_SIZE 1024
+#define PARAM_ARENA_MAX_SIZE (1024 * 1024)
+
+// Formats of ODBCResult.exportRows
+#define EXPORT_CSV 0
+#define EXPORT_NDJSON 1
+
+// Conversions of fetched values, set from the properties of ODBCResult
+#define VALUE_TIMESTAMP_NUMBER 0x01
+#define VALUE_BIGINT_NUMBER 0x02
+#define VALUE_BIGINT_BIGINT 0x04
+#define VALUE_DECIMAL_NUMBER 0x08
+#define VALUE_TRIM_CHAR 0x10
+
+// Values of the bigintMode and decimalMode properties of ODBCResult
+#define BIGINT_STRING 0
+#define BIGINT_NUMBER 1
+#define BIGINT_BIGINT 2
+#define DECIMAL_STRING 0
+#define DECIMAL_NUMBER 1
 #define SQL_DESTROY 9999
 
 #if (NODE_MAJOR_VERSION >= 10)
@@ -63,24 +121,15 @@ using namespace node;
 #endif
 
 
-// Free Bind Parameters 
-#define FREE_PARAMS( params, count )                                 \
-    Parameter prm;                                                   \
-    if(params != NULL ) {                                            \
-      for (int i = 0; i < count; i++) {                              \
-        if (prm = params[i], prm.buffer != NULL) {                   \
-          switch (prm.c_type) {                                      \
-            case SQL_C_LONG:    delete (int64_t *)prm.buffer; break; \
-            case SQL_C_DOUBLE:  delete (double  *)prm.buffer; break; \
-            case SQL_C_BIT:     delete (bool    *)prm.buffer; break; \
-            case SQL_C_CHAR:                                         \
-            case SQL_C_WCHAR:                                        \
-            default:     free(prm.buffer); prm.buffer = NULL; break; \
-          }                                                          \
-        }                                                            \
-      }                                                              \
-      free(params);                                                  \
-    }                                                                \
+// Free Bind Parameters, all allocated from arena
+#define FREE_PARAMS( params, count, arena )                          \
+    ODBC::FreeParamArena( &(arena) );                                \
+    params = NULL;                                                   \
+    count = 0;
+
+// Release Bind Parameters but keep their arena for the next ones
+#define RESET_PARAMS( params, count, arena )                         \
+    ODBC::ResetParamArena( &(arena) );                               \
     params = NULL;                                                   \
     count = 0;
 
@@ -105,6 +154,14 @@ typedef struct {
   SQLUSMALLINT index;
 } Column;
 
+// Column metadata of a prepared statement, shared with the results of its
+// executions. Freed by ReleaseColumnCache with the last reference.
+typedef struct {
+  Column      *columns;
+  short        colCount;
+  int          refs;
+} ColumnCache;
+
 typedef struct {
   SQLSMALLINT  paramtype;
   SQLSMALLINT  c_type;
@@ -118,6 +175,117 @@ typedef struct {
   SQLINTEGER   fileIndicator; // For BindFileToParam
 } Parameter;
 
+// Bump allocator for a set of Parameters and their values. A block twice the
+// size of the last one is added when it is full. ResetParamArena leaves one
+// block big enough for everything allocated since the last reset, so that
+// parameters of the same sizes next time need no allocation at all.
+typedef struct ArenaBlock {
+  struct ArenaBlock *next;
+  size_t             capacity;
+  size_t             used;
+} ArenaBlock;
+
+typedef struct {
+  ArenaBlock  *blocks;
+  size_t       allocated;
+} ParamArena;
+
+// The values of one parameter for all the rows of an executeBatch, bound
+// column-wise with SQL_ATTR_PARAMSET_SIZE: width bytes and one
+// length/indicator per row. In a synchronous execution buffer may be the
+// memory of a typed array, with no indicators when none of its values is
+// NULL.
+typedef struct {
+  SQLSMALLINT  c_type;
+  SQLSMALLINT  type;
+  SQLULEN      size;
+  SQLSMALLINT  decimals;
+  SQLLEN       width;
+  char        *buffer;
+  SQLLEN      *indicators;
+} ParameterArray;
+
+// Column values fetched on the thread pool: width bytes and one
+// length/indicator per row, either a bound rowset or a single row read with
+// SQLGetData.
+typedef struct {
+  SQLSMALLINT  c_type;
+  SQLLEN       width;
+  char        *buffer;
+  SQLLEN      *indicators;
+} ColumnBuffer;
+
+// All the values of one column in FETCH_COLUMNAR mode. Fixed width values are
+// stored width bytes per row; character and binary data are stored back to
+// back in values with rowCount + 1 offsets. Bit n of nulls is set when row n
+// is NULL.
+typedef struct {
+  SQLSMALLINT  c_type;
+  SQLLEN       width;
+  SQLULEN      rowCount;
+  SQLULEN      rowCapacity;
+  char        *values;
+  size_t       dataLength;
+  size_t       dataCapacity;
+  int32_t     *offsets;
+  uint8_t     *nulls;
+} ColumnVector;
+
+// Rows of an export formatted as CSV or NDJSON, written out once
+// EXPORT_BLOCK_SIZE bytes are in. text holds character data transcoded to
+// UTF-8 in UNICODE builds.
+typedef struct {
+  char        *data;
+  size_t       length;
+  size_t       capacity;
+#ifdef UNICODE
+  char        *text;
+  size_t       textCapacity;
+#endif
+} ExportBuffer;
+
+typedef struct {
+  uint16_t    *buffer;
+  int          length;
+  int          initialLength;
+  int          maxLength;
+} ScratchBuffer;
+
+// Character values already converted for a result with dedupeStrings, so
+// that repeated values share one V8 string. One table per column, so that a
+// column with many distinct values does not leave no room for the others.
+// Open addressing on the bytes of the value; length is -1 in an empty slot.
+// Filled up to half its slots.
+typedef struct {
+  SQLLEN                   length;
+  char                     key[DICTIONARY_KEY_SIZE];
+  Nan::Persistent<String>  value;
+} DictionaryEntry;
+
+typedef struct {
+  DictionaryEntry *entries;
+  int              count;
+} DictionaryTable;
+
+// tables by column number, each allocated with the first value of its column
+typedef struct {
+  DictionaryTable *tables;
+  int              tableCount;
+} StringDictionary;
+
+// The rows of one rowset kept for the rows of a FETCH_LAZY fetch, which
+// convert a value only when it is read. The column metadata, buffers and
+// values are copied into one allocation, owned by a Buffer that every row of
+// the rowset refers to; columns have no names and character columns are only
+// as wide as their longest value.
+typedef struct {
+  Column       *columns;
+  ColumnBuffer *buffers;
+  short         colCount;
+  int           flags;
+  SQLULEN       rowCount;
+} LazyRowset;
+
 class ODBC : public Nan::ObjectWrap {
   public:
     static Nan::Persistent<Function> constructor;
@@ -126,18 +294,72 @@ class ODBC : public Nan::ObjectWrap {
     
     static void Init(v8::Local<Object> exports);
     static Column* GetColumns(SQLHSTMT hStmt, short* colCount);
+    static Nan::Persistent<String>* GetColumnNames(Column* columns, short colCount);
+    static void FreeColumnNames(Nan::Persistent<String>* names, short colCount);
+    static Local<ObjectTemplate> GetRowTemplate(Nan::Persistent<String>* names, short colCount);
+    static Local<ObjectTemplate> GetLazyRowTemplate(Nan::Persistent<String>* names, short colCount);
     static void FreeColumns(Column* columns, short* colCount);
-    static Local<Value> GetColumnValue(SQLHSTMT hStmt, Column column, uint16_t* buffer, int bufferLength);
+    static ColumnCache* GetColumnCache(SQLHSTMT hStmt);
+    static void ReleaseColumnCache(ColumnCache* cache);
+    static StringDictionary* AllocStringDictionary();
+    static void FreeStringDictionary(StringDictionary* dictionary);
+    static Local<String> GetDictionaryString(StringDictionary* dictionary, SQLUSMALLINT column,
+                                             const char* value, SQLLEN length);
+    static Local<Value> GetColumnValue(SQLHSTMT hStmt, Column column, ScratchBuffer* scratch, int flags = 0, StringDictionary* dictionary = NULL);
+    static bool AllocScratchBuffer(ScratchBuffer* scratch, int length);
+    static bool GrowScratchBuffer(ScratchBuffer* scratch, SQLLEN length);
+    static void ShrinkScratchBuffer(ScratchBuffer* scratch);
+    static void FreeScratchBuffer(ScratchBuffer* scratch);
+    static Local<Value> GetTimestampValue(SQL_TIMESTAMP_STRUCT &odbcTime, int flags = 0);
+    static Local<Value> GetBigIntValue(SQLBIGINT value, int flags = 0);
+    static double GetTimestampMs(SQL_TIMESTAMP_STRUCT &odbcTime);
+    static SQLSMALLINT GetColumnCType(Column column, SQLLEN* width, int flags = 0);
+    static SQLSMALLINT GetLobCType(Column column);
+    static ColumnBuffer* BindColumns(SQLHSTMT hStmt, Column* columns, short colCount, SQLULEN* rowsetSize, int flags = 0, int sets = 1);
+    static void FreeColumnBuffers(ColumnBuffer* buffers);
+    static ColumnBuffer* AllocRowBuffer(Column* columns, short colCount, int flags = 0);
+    static void FreeRowBuffer(ColumnBuffer* row, short colCount);
+    static void ShrinkRowBuffer(ColumnBuffer* row, short colCount, int maxLength);
+    static SQLRETURN FetchRowData(SQLHSTMT hStmt, Column* columns, short colCount, ColumnBuffer* row);
+    static SQLRETURN FetchColumnData(SQLHSTMT hStmt, Column column, ColumnBuffer* data);
+    static Local<Value> TakeBinaryValue(ColumnBuffer* data);
+    static Local<Value> GetColumnBufferValue(Column column, ColumnBuffer* buffer, SQLULEN row, int flags = 0, StringDictionary* dictionary = NULL);
+    static ColumnVector* AllocColumnVectors(Column* columns, short colCount, int flags = 0);
+    static bool ReserveColumnVector(ColumnVector* vector, size_t dataLength);
+    static bool AppendColumnVectors(Column* columns, ColumnVector* vectors, short colCount, ColumnBuffer* buffers, SQLULEN row, int flags = 0);
+    static void FreeColumnVectors(ColumnVector* vectors, short colCount);
+    static Local<Array> GetColumnVectorsArray(Column* columns, ColumnVector* vectors, short colCount);
+    static char* GetArrowStream(Column* columns, ColumnVector* vectors, short colCount, size_t* length);
+    static bool AppendExportHeader(Column* columns, short colCount, ExportBuffer* out);
+    static bool AppendExportRow(Column* columns, short colCount, ColumnBuffer* buffers, SQLULEN row,
+                                int format, int flags, ExportBuffer* out);
+    static void FreeExportBuffer(ExportBuffer* out);
+    static Local<Object> NewExternalBuffer(char* data, size_t length);
+    static Local<Value> NewLazyRowset(Column* columns, short colCount, ColumnBuffer* buffers, SQLULEN rowCount, int flags);
+    static Local<Object> GetLazyRecord(Local<ObjectTemplate> rowTemplate, Local<Value> rowset, SQLULEN row);
     static Local<Value> GetOutputParameter(Parameter prm);
-    static Local<Object> GetRecordTuple (SQLHSTMT hStmt, Column* columns, short* colCount, uint16_t* buffer, int bufferLength);
-    static Local<Value> GetRecordArray (SQLHSTMT hStmt, Column* columns, short* colCount, uint16_t* buffer, int bufferLength);
+    static Local<Object> GetRecordTuple (SQLHSTMT hStmt, Column* columns, short* colCount, ScratchBuffer* scratch, Nan::Persistent<String>* names = NULL, Local<ObjectTemplate> rowTemplate = Local<ObjectTemplate>(), int flags = 0, StringDictionary* dictionary = NULL);
+    static Local<Value> GetRecordArray (SQLHSTMT hStmt, Column* columns, short* colCount, ScratchBuffer* scratch, int flags = 0, StringDictionary* dictionary = NULL);
+    static Local<Object> GetBufferedRecordTuple (Column* columns, short* colCount, ColumnBuffer* buffers, SQLULEN row, Nan::Persistent<String>* names = NULL, Local<ObjectTemplate> rowTemplate = Local<ObjectTemplate>(), int flags = 0, StringDictionary* dictionary = NULL);
+    static Local<Value> GetBufferedRecordArray (Column* columns, short* colCount, ColumnBuffer* buffers, SQLULEN row, int flags = 0, StringDictionary* dictionary = NULL);
     static Local<Value> CallbackSQLError(SQLSMALLINT handleType, SQLHANDLE handle, Nan::Callback* cb);
     static Local<Value> CallbackSQLError (SQLSMALLINT handleType, SQLHANDLE handle, char* message, Nan::Callback* cb);
     static Local<Value> GetSQLError (SQLSMALLINT handleType, SQLHANDLE handle);
     static Local<Value> GetSQLError (SQLSMALLINT handleType, SQLHANDLE handle, char* message);
-    static Local<Array>  GetAllRecordsSync (SQLHENV hENV, SQLHDBC hDBC, SQLHSTMT hSTMT, uint16_t* buffer, int bufferLength);
-    static Parameter* GetParametersFromArray (Local<Array> values, int* paramCount);
-    static SQLRETURN  BindParameters(SQLHSTMT hSTMT, Parameter params[], int count);
+    static Local<Array>  GetAllRecordsSync (SQLHENV hENV, SQLHDBC hDBC, SQLHSTMT hSTMT, ScratchBuffer* scratch);
+    static Parameter* GetParametersFromArray (Local<Array> values, int* paramCount, ParamArena* arena);
+    static void*      ArenaAlloc(ParamArena* arena, size_t size);
+    static void       ResetParamArena(ParamArena* arena);
+    static void       FreeParamArena(ParamArena* arena);
+    static SQLRETURN  BindParameters(SQLHSTMT hSTMT, Parameter params[], int count, const char* changed = NULL);
+    static char*      UpdateParameters(Local<Array> values, Parameter params[], int count,
+                                       ParamArena* arena, ParamArena* scratch);
+    static ParameterArray* GetParameterArrays(Local<Array> rows, int* paramCount, SQLULEN* rowCount);
+    static ParameterArray* GetColumnParameterArrays(Local<Array> columns, int* paramCount, SQLULEN* rowCount,
+                                                    bool inPlace);
+    static SQLRETURN  BindParameterArrays(SQLHSTMT hSTMT, ParameterArray arrays[], int count, SQLULEN rowCount,
+                                          SQLUSMALLINT* status, SQLULEN* processed);
+    static void       ResetParameterArrays(SQLHSTMT hSTMT);
     
     void Free();
     
@@ -146,13 +368,15 @@ class ODBC : public Nan::ObjectWrap {
 
     ~ODBC();
 
-    static void GetStringParam(Local<Value> value, Parameter * param, int num);
+    static void GetStringParam(Local<Value> value, Parameter * param, int num, ParamArena* arena);
     static void GetNullParam(Parameter * param, int num);
-    static void GetInt32Param(Local<Value> value, Parameter * param, int num);
-    static void GetNumberParam(Local<Value> value, Parameter * param, int num);
-    static void GetBoolParam(Local<Value> value, Parameter * param, int num);
+    static void GetInt32Param(Local<Value> value, Parameter * param, int num, ParamArena* arena);
+    static void GetNumberParam(Local<Value> value, Parameter * param, int num, ParamArena* arena);
+    static void GetBoolParam(Local<Value> value, Parameter * param, int num, ParamArena* arena);
 
     static NAN_METHOD(New);
+    
+    static NAN_GETTER(LazyValueGetter);
 
     //async methods
     static NAN_METHOD(CreateConnection);
@@ -36,6 +36,7 @@ Nan::Persistent<Function> ODBCConnection::constructor;
 Nan::Persistent<String> ODBCConnection::OPTION_SQL;
 Nan::Persistent<String> ODBCConnection::OPTION_PARAMS;
 Nan::Persistent<String> ODBCConnection::OPTION_NORESULTS;
+Nan::Persistent<String> ODBCConnection::OPTION_CURSOR_TYPE;
 
 void ODBCConnection::Init(v8::Local<Object> exports) {
   DEBUG_PRINTF("ODBCConnection::Init\n");
@@ -44,6 +45,7 @@ void ODBCConnection::Init(v8::Local<Object> exports) {
   OPTION_SQL.Reset(Nan::New<String>("sql").ToLocalChecked());
   OPTION_PARAMS.Reset(Nan::New<String>("params").ToLocalChecked());
   OPTION_NORESULTS.Reset(Nan::New<String>("noResults").ToLocalChecked());
+  OPTION_CURSOR_TYPE.Reset(Nan::New<String>("cursorType").ToLocalChecked());
 
   Local<FunctionTemplate> constructor_template = Nan::New<FunctionTemplate>(New);
 
@@ -1022,7 +1024,8 @@ NAN_METHOD(ODBCConnection::Query) {
     
     data->params = ODBC::GetParametersFromArray(
       Local<Array>::Cast(info[1]),
-      &data->paramCount);
+      &data->paramCount,
+      &data->paramArena);
     
     cb = Local<Function>::Cast(info[2]);
   }
@@ -1062,7 +1065,8 @@ NAN_METHOD(ODBCConnection::Query) {
       if (Nan::HasOwnProperty(obj, optionParamsKey).IsJust() && Nan::Get(obj, optionParamsKey).ToLocalChecked()->IsArray()) {
         data->params = ODBC::GetParametersFromArray(
           Local<Array>::Cast(Nan::Get(obj, optionParamsKey).ToLocalChecked()),
-          &data->paramCount);
+          &data->paramCount,
+          &data->paramArena);
       }
       else {
         data->paramCount = 0;
@@ -1075,6 +1079,14 @@ NAN_METHOD(ODBCConnection::Query) {
       else {
         data->noResultObject = false;
       }
+      
+      Local<String> optionCursorTypeKey = Nan::New(OPTION_CURSOR_TYPE);
+      if (Nan::HasOwnProperty(obj, optionCursorTypeKey).IsJust() && Nan::Get(obj, optionCursorTypeKey).ToLocalChecked()->IsInt32()) {
+        data->cursorType = Nan::To<int32_t>(Nan::Get(obj, optionCursorTypeKey).ToLocalChecked()).FromJust();
+      }
+      else {
+        data->cursorType = SQL_CURSOR_FORWARD_ONLY;
+      }
     }
     else {
       return Nan::ThrowTypeError("ODBCConnection::Query(): Argument 0 must be a String or an Object.");
@@ -1132,6 +1144,16 @@ void ODBCConnection::UV_Query(uv_work_t* req) {
                   &data->hSTMT );
 
  uv_mutex_unlock(&ODBC::g_odbcMutex);
+  //a scrollable cursor has to be asked for before the statement runs
+  if (data->cursorType != SQL_CURSOR_FORWARD_ONLY) {
+    ret = SQLSetStmtAttr(data->hSTMT, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) (intptr_t) data->cursorType, 0);
+    
+    if (!SQL_SUCCEEDED(ret)) {
+      data->result = ret;
+      return;
+    }
+  }
+  
   //check to see if should excute a direct or a parameter bound query
   if (!data->paramCount) {
     // execute the query directly
@@ -1235,9 +1257,7 @@ void ODBCConnection::UV_AfterQuery(uv_work_t* req, int status) {
   
   delete data->cb;
 
-  if (data->paramCount) {
-      FREE_PARAMS( data->params, data->paramCount ) ;
-  }
+  FREE_PARAMS( data->params, data->paramCount, data->paramArena ) ;
 
   free(data->sql);
   free(data->catalog);
@@ -1268,13 +1288,15 @@ NAN_METHOD(ODBCConnection::QuerySync) {
 
   ODBCConnection* conn = Nan::ObjectWrap::Unwrap<ODBCConnection>(info.Holder());
   
-  Parameter* params = new Parameter[0];
+  Parameter* params = NULL;
+  ParamArena paramArena = { NULL, 0 };
   SQLRETURN ret;
   SQLHSTMT hSTMT;
   int paramCount = 0;
   int outParamCount = 0; // Non-zero tells its a SP.
   Local<Array> sp_result = Nan::New<Array>();
   bool noResultObject = false;
+  int cursorType = SQL_CURSOR_FORWARD_ONLY;
   
   //Check arguments for different variations of calling this function
   if (info.Length() == 2) {
@@ -1293,7 +1315,8 @@ NAN_METHOD(ODBCConnection::QuerySync) {
 
     params = ODBC::GetParametersFromArray(
       Local<Array>::Cast(info[1]),
-      &paramCount);
+      &paramCount,
+      &paramArena);
 
   }
   else if (info.Length() == 1 ) {
@@ -1337,7 +1360,8 @@ NAN_METHOD(ODBCConnection::QuerySync) {
       if (Nan::HasOwnProperty(obj, optionParamsKey).IsJust() && Nan::Get(obj, optionParamsKey).ToLocalChecked()->IsArray()) {
         params = ODBC::GetParametersFromArray(
           Local<Array>::Cast(Nan::Get(obj, optionParamsKey).ToLocalChecked()),
-          &paramCount);
+          &paramCount,
+          &paramArena);
       }
       else {
         paramCount = 0;
@@ -1351,6 +1375,11 @@ NAN_METHOD(ODBCConnection::QuerySync) {
       else {
         noResultObject = false;
       }
+      
+      Local<String> optionCursorTypeKey = Nan::New(OPTION_CURSOR_TYPE);
+      if (Nan::HasOwnProperty(obj, optionCursorTypeKey).IsJust() && Nan::Get(obj, optionCursorTypeKey).ToLocalChecked()->IsInt32()) {
+        cursorType = Nan::To<int32_t>(Nan::Get(obj, optionCursorTypeKey).ToLocalChecked()).FromJust();
+      }
     }
     else {
       return Nan::ThrowTypeError("ODBCConnection::QuerySync(): Argument 0 must be a String or an Object.");
@@ -1368,6 +1397,11 @@ NAN_METHOD(ODBCConnection::QuerySync) {
                   &hSTMT );
   uv_mutex_unlock(&ODBC::g_odbcMutex);
 
+  //a scrollable cursor has to be asked for before the statement runs
+  if (SQL_SUCCEEDED(ret) && cursorType != SQL_CURSOR_FORWARD_ONLY) {
+    ret = SQLSetStmtAttr(hSTMT, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) (intptr_t) cursorType, 0);
+  }
+
   DEBUG_PRINTF("ODBCConnection::QuerySync - hSTMT=%X, noResultObject=%i\n", hSTMT, noResultObject);
   //check to see if should excute a direct or a parameter bound query
   if (!SQL_SUCCEEDED(ret)) {
@@ -1401,9 +1435,11 @@ NAN_METHOD(ODBCConnection::QuerySync) {
         }
       }
     }
-    FREE_PARAMS( params, paramCount ) ;
   }
   
+  //also when the statement could not be set up
+  FREE_PARAMS( params, paramCount, paramArena ) ;
+  
   delete sql;
   
   //check to see if there was an error during execution
@@ -29,6 +29,7 @@ class ODBCConnection : public Nan::ObjectWrap {
    static Nan::Persistent<String> OPTION_SQL;
    static Nan::Persistent<String> OPTION_PARAMS;
    static Nan::Persistent<String> OPTION_NORESULTS;
+   static Nan::Persistent<String> OPTION_CURSOR_TYPE;
    static Nan::Persistent<Function> constructor;
    
    static void Init(v8::Local<Object> exports);
@@ -131,8 +132,10 @@ struct query_work_data {
   
   Parameter *params;
   int paramCount;
+  ParamArena paramArena;
   int completionType;
   bool noResultObject;
+  int cursorType;
   
   void *sql;
   void *catalog;
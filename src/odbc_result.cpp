@@ -18,6 +18,7 @@
 */
 
 #include <string.h>
+#include <fcntl.h>
 #include <v8.h>
 #include <node.h>
 #include <node_version.h>
@@ -34,6 +35,9 @@ using namespace node;
 
 Nan::Persistent<Function> ODBCResult::constructor;
 Nan::Persistent<String> ODBCResult::OPTION_FETCH_MODE;
+Nan::Persistent<String> ODBCResult::OPTION_ROWSET_SIZE;
+Nan::Persistent<String> ODBCResult::OPTION_LOB_STREAM;
+Nan::Persistent<String> ODBCResult::OPTION_PREFETCH;
 
 void ODBCResult::Init(v8::Local<Object> exports) {
   DEBUG_PRINTF("ODBCResult::Init\n");
@@ -50,6 +54,12 @@ void ODBCResult::Init(v8::Local<Object> exports) {
   // Prototype Methods
   Nan::SetPrototypeMethod(constructor_template, "fetchAll", FetchAll);
   Nan::SetPrototypeMethod(constructor_template, "fetch", Fetch);
+  Nan::SetPrototypeMethod(constructor_template, "fetchMany", FetchMany);
+  Nan::SetPrototypeMethod(constructor_template, "fetchAbsolute", FetchAbsolute);
+  Nan::SetPrototypeMethod(constructor_template, "fetchRelative", FetchRelative);
+  Nan::SetPrototypeMethod(constructor_template, "fetchArrow", FetchArrow);
+  Nan::SetPrototypeMethod(constructor_template, "exportRows", ExportRows);
+  Nan::SetPrototypeMethod(constructor_template, "readLob", ReadLob);
 
   Nan::SetPrototypeMethod(constructor_template, "moreResultsSync", MoreResultsSync);
   Nan::SetPrototypeMethod(constructor_template, "closeSync", CloseSync);
@@ -60,6 +70,17 @@ void ODBCResult::Init(v8::Local<Object> exports) {
   // Properties
   OPTION_FETCH_MODE.Reset(Nan::New("fetchMode").ToLocalChecked());
   Nan::SetAccessor(instance_template, Nan::New("fetchMode").ToLocalChecked(), FetchModeGetter, FetchModeSetter);
+  OPTION_ROWSET_SIZE.Reset(Nan::New("rowsetSize").ToLocalChecked());
+  OPTION_LOB_STREAM.Reset(Nan::New("lobStream").ToLocalChecked());
+  Nan::SetAccessor(instance_template, Nan::New("rowsetSize").ToLocalChecked(), RowsetSizeGetter, RowsetSizeSetter);
+  OPTION_PREFETCH.Reset(Nan::New("prefetch").ToLocalChecked());
+  Nan::SetAccessor(instance_template, Nan::New("prefetch").ToLocalChecked(), PrefetchGetter, PrefetchSetter);
+  Nan::SetAccessor(instance_template, Nan::New("maxBufferSize").ToLocalChecked(), MaxBufferSizeGetter, MaxBufferSizeSetter);
+  Nan::SetAccessor(instance_template, Nan::New("timestampAsNumber").ToLocalChecked(), TimestampAsNumberGetter, TimestampAsNumberSetter);
+  Nan::SetAccessor(instance_template, Nan::New("trimChar").ToLocalChecked(), TrimCharGetter, TrimCharSetter);
+  Nan::SetAccessor(instance_template, Nan::New("bigintMode").ToLocalChecked(), BigIntModeGetter, BigIntModeSetter);
+  Nan::SetAccessor(instance_template, Nan::New("decimalMode").ToLocalChecked(), DecimalModeGetter, DecimalModeSetter);
+  Nan::SetAccessor(instance_template, Nan::New("dedupeStrings").ToLocalChecked(), DedupeStringsGetter, DedupeStringsSetter);
   
   // Attach the Database Constructor to the target object
   constructor.Reset(Nan::GetFunction(constructor_template).ToLocalChecked());
@@ -75,6 +96,9 @@ ODBCResult::~ODBCResult() {
 void ODBCResult::Free() {
   DEBUG_PRINTF("ODBCResult::Free m_hSTMT=%X m_canFreeHandle=%X\n", m_hSTMT, m_canFreeHandle);
   
+  //never leave column arrays bound to a statement we do not own
+  ReleaseColumns();
+  
   if (m_hSTMT && m_canFreeHandle) {
     uv_mutex_lock(&ODBC::g_odbcMutex);
     
@@ -85,10 +109,13 @@ void ODBCResult::Free() {
     uv_mutex_unlock(&ODBC::g_odbcMutex);
   }
   
-  if (bufferLength > 0) {
-    bufferLength = 0;
-    free(buffer);
-  }
+  ODBC::FreeScratchBuffer(&scratch);
+  
+  ODBC::FreeStringDictionary(dictionary);
+  dictionary = NULL;
+  
+  free(lobBuffer);
+  lobBuffer = NULL;
 }
 
 NAN_METHOD(ODBCResult::New) {
@@ -118,19 +145,49 @@ NAN_METHOD(ODBCResult::New) {
   //free the pointer to canFreeHandle
   delete canFreeHandle;
 
-  //specify the buffer length
-  objODBCResult->bufferLength = MAX_VALUE_SIZE - 1;
-  
   //initialze a buffer for this object
-  objODBCResult->buffer = (uint16_t *) malloc(objODBCResult->bufferLength + 1);
+  ODBC::AllocScratchBuffer(&objODBCResult->scratch, MAX_VALUE_SIZE - 1);
   //TODO: make sure the malloc succeeded
 
   //set the initial colCount to 0
   objODBCResult->colCount = 0;
+  
+  //column metadata of the first result set, cached by a prepared statement
+  objODBCResult->columnCache = NULL;
+  
+  if (info.Length() > 4 && info[4]->IsExternal()) {
+    objODBCResult->columnCache = static_cast<ColumnCache *>(Local<External>::Cast(info[4])->Value());
+    objODBCResult->columnCache->refs++;
+  }
 
   //default fetchMode to FETCH_OBJECT
   objODBCResult->m_fetchMode = FETCH_OBJECT;
   
+  //fetch one row at a time unless a rowsetSize is set
+  objODBCResult->m_rowsetSize = 1;
+  objODBCResult->m_valueFlags = 0;
+  objODBCResult->columnNames = NULL;
+  objODBCResult->rowTemplateLoaded = false;
+  objODBCResult->lazyTemplateLoaded = false;
+  objODBCResult->rowBuffer = NULL;
+  objODBCResult->dictionary = NULL;
+  objODBCResult->vectors = NULL;
+  objODBCResult->lobIndex = 0;
+  objODBCResult->lobCType = 0;
+  objODBCResult->lobBuffer = NULL;
+  objODBCResult->lobLength = 0;
+  objODBCResult->rowset = NULL;
+  objODBCResult->rowsetSize = 0;
+  objODBCResult->rowsetRequest = 0;
+  objODBCResult->rowsetSets = 1;
+  objODBCResult->rowsetOffset = 0;
+  objODBCResult->rowsetNext = 0;
+  objODBCResult->rowsetFilled = 0;
+  objODBCResult->rowsFetched[0] = 0;
+  objODBCResult->rowsFetched[1] = 0;
+  objODBCResult->m_prefetch = false;
+  objODBCResult->rowStatus = NULL;
+  
   objODBCResult->Wrap(info.Holder());
   
   info.GetReturnValue().Set(info.Holder());
@@ -154,203 +211,724 @@ NAN_SETTER(ODBCResult::FetchModeSetter) {
   }
 }
 
-/*
- * Fetch
- */
+NAN_GETTER(ODBCResult::RowsetSizeGetter) {
+  Nan::HandleScope scope;
 
-NAN_METHOD(ODBCResult::Fetch) {
-  DEBUG_PRINTF("ODBCResult::Fetch\n");
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New(obj->m_rowsetSize));
+}
+
+NAN_SETTER(ODBCResult::RowsetSizeSetter) {
   Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
   
-  ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
-  
-  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
-  
-  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
-  
-  Local<Function> cb;
-   
-  //set the fetch mode to the default of this instance
-  data->fetchMode = objODBCResult->m_fetchMode;
-  
-  if (info.Length() == 1 && info[0]->IsFunction()) {
-    cb = Local<Function>::Cast(info[0]);
+  if (value->IsNumber() && Nan::To<int32_t>(value).FromJust() > 0) {
+    obj->m_rowsetSize = Nan::To<int32_t>(value).FromJust();
   }
-  else if (info.Length() == 2 && info[0]->IsObject() && info[1]->IsFunction()) {
-    cb = Local<Function>::Cast(info[1]);  
-    
-    Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked(); 
+}
+
+NAN_GETTER(ODBCResult::MaxBufferSizeGetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New(obj->scratch.maxLength));
+}
+
+NAN_SETTER(ODBCResult::MaxBufferSizeSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  if (value->IsNumber() && Nan::To<int32_t>(value).FromJust() > 0) {
+    obj->scratch.maxLength = Nan::To<int32_t>(value).FromJust();
     
-    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
-    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
-      data->fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    if (obj->scratch.length > obj->scratch.maxLength) {
+      ODBC::ShrinkScratchBuffer(&obj->scratch);
     }
   }
-  else {
-    return Nan::ThrowTypeError("ODBCResult::Fetch(): 1 or 2 arguments are required. The last argument must be a callback function.");
-  }
-  
-  data->cb = new Nan::Callback(cb);
-  
-  data->objResult = objODBCResult;
-  work_req->data = data;
-  
-  uv_queue_work(
-    uv_default_loop(), 
-    work_req, 
-    UV_Fetch, 
-    (uv_after_work_cb)UV_AfterFetch);
+}
 
-  objODBCResult->Ref();
+NAN_GETTER(ODBCResult::TimestampAsNumberGetter) {
+  Nan::HandleScope scope;
 
-  info.GetReturnValue().Set(Nan::Undefined());
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New((obj->m_valueFlags & VALUE_TIMESTAMP_NUMBER) != 0));
 }
 
-void ODBCResult::UV_Fetch(uv_work_t* work_req) {
-  DEBUG_PRINTF("ODBCResult::UV_Fetch\n");
-  
-  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+NAN_SETTER(ODBCResult::TimestampAsNumberSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
   
-  data->result = SQLFetch(data->objResult->m_hSTMT);
+  if (value->IsBoolean()) {
+    if (Nan::To<bool>(value).FromJust()) {
+      obj->m_valueFlags |= VALUE_TIMESTAMP_NUMBER;
+    }
+    else {
+      obj->m_valueFlags &= ~VALUE_TIMESTAMP_NUMBER;
+    }
+  }
 }
 
-void ODBCResult::UV_AfterFetch(uv_work_t* work_req, int status) {
-  DEBUG_PRINTF("ODBCResult::UV_AfterFetch\n");
+NAN_GETTER(ODBCResult::TrimCharGetter) {
   Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New((obj->m_valueFlags & VALUE_TRIM_CHAR) != 0));
+}
+
+NAN_SETTER(ODBCResult::TrimCharSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
   
-  fetch_work_data* data = (fetch_work_data *)(work_req->data);
-  
-  SQLRETURN ret = data->result;
-  //TODO: we should probably define this on the work data so we
-  //don't have to keep creating it?
-  Local<Value> objError;
-  bool moreWork = true;
-  bool error = false;
-  
-  if (data->objResult->colCount == 0) {
-    data->objResult->columns = ODBC::GetColumns(
-      data->objResult->m_hSTMT, 
-      &data->objResult->colCount);
+  if (value->IsBoolean()) {
+    if (Nan::To<bool>(value).FromJust()) {
+      obj->m_valueFlags |= VALUE_TRIM_CHAR;
+    }
+    else {
+      obj->m_valueFlags &= ~VALUE_TRIM_CHAR;
+    }
   }
-  
-  //check to see if the result has no columns
-  if (data->objResult->colCount == 0) {
-    //this means
-    moreWork = false;
+}
+
+NAN_GETTER(ODBCResult::BigIntModeGetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  int mode = BIGINT_STRING;
+
+  if (obj->m_valueFlags & VALUE_BIGINT_BIGINT) {
+    mode = BIGINT_BIGINT;
   }
-  //check to see if there was an error
-  else if (ret == SQL_ERROR)  {
-    moreWork = false;
-    error = true;
-    
-    objError = ODBC::GetSQLError(
-      SQL_HANDLE_STMT, 
-      data->objResult->m_hSTMT,
-      (char *) "Error in ODBCResult::UV_AfterFetch");
+  else if (obj->m_valueFlags & VALUE_BIGINT_NUMBER) {
+    mode = BIGINT_NUMBER;
   }
-  //check to see if we are at the end of the recordset
-  else if (ret == SQL_NO_DATA) {
-    moreWork = false;
+
+  info.GetReturnValue().Set(Nan::New(mode));
+}
+
+NAN_SETTER(ODBCResult::BigIntModeSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  if (value->IsNumber()) {
+    int mode = Nan::To<int32_t>(value).FromJust();
+
+    obj->m_valueFlags &= ~(VALUE_BIGINT_NUMBER | VALUE_BIGINT_BIGINT);
+    if (mode == BIGINT_NUMBER) {
+      obj->m_valueFlags |= VALUE_BIGINT_NUMBER;
+    }
+    else if (mode == BIGINT_BIGINT) {
+      obj->m_valueFlags |= VALUE_BIGINT_BIGINT;
+    }
   }
+}
 
-  if (moreWork) {
-    Local<Value> info[2];
+NAN_GETTER(ODBCResult::DecimalModeGetter) {
+  Nan::HandleScope scope;
 
-    info[0] = Nan::Null();
-    if (data->fetchMode == FETCH_ARRAY) {
-      info[1] = ODBC::GetRecordArray(
-        data->objResult->m_hSTMT,
-        data->objResult->columns,
-        &data->objResult->colCount,
-        data->objResult->buffer,
-        data->objResult->bufferLength);
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New(
+    (obj->m_valueFlags & VALUE_DECIMAL_NUMBER) ? DECIMAL_NUMBER : DECIMAL_STRING));
+}
+
+NAN_SETTER(ODBCResult::DecimalModeSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  if (value->IsNumber()) {
+    if (Nan::To<int32_t>(value).FromJust() == DECIMAL_NUMBER) {
+      obj->m_valueFlags |= VALUE_DECIMAL_NUMBER;
     }
     else {
-      info[1] = ODBC::GetRecordTuple(
-        data->objResult->m_hSTMT,
-        data->objResult->columns,
-        &data->objResult->colCount,
-        data->objResult->buffer,
-        data->objResult->bufferLength);
+      obj->m_valueFlags &= ~VALUE_DECIMAL_NUMBER;
     }
+  }
+}
 
-    Nan::TryCatch try_catch;
+/*
+ * DedupeStrings
+ *
+ * When true, CHAR and VARCHAR values that repeat within the result are
+ * returned as the same string; see GetDictionaryString.
+ */
 
-    data->cb->Call(2, info);
-    delete data->cb;
+NAN_GETTER(ODBCResult::DedupeStringsGetter) {
+  Nan::HandleScope scope;
 
-    if (try_catch.HasCaught()) {
-      FatalException(try_catch);
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New(obj->dictionary != NULL));
+}
+
+NAN_SETTER(ODBCResult::DedupeStringsSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  if (!value->IsBoolean()) {
+    return;
+  }
+  
+  if (Nan::To<bool>(value).FromJust()) {
+    if (obj->dictionary == NULL) {
+      obj->dictionary = ODBC::AllocStringDictionary();
     }
   }
   else {
-    ODBC::FreeColumns(data->objResult->columns, &data->objResult->colCount);
-    
-    Local<Value> info[2];
-    
-    //if there was an error, pass that as arg[0] otherwise Null
-    if (error) {
-      info[0] = objError;
-    }
-    else {
-      info[0] = Nan::Null();
-    }
-    
-    info[1] = Nan::Null();
+    ODBC::FreeStringDictionary(obj->dictionary);
+    obj->dictionary = NULL;
+  }
+}
 
-    Nan::TryCatch try_catch;
+NAN_GETTER(ODBCResult::PrefetchGetter) {
+  Nan::HandleScope scope;
 
-    data->cb->Call(2, info);
-    delete data->cb;
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
 
-    if (try_catch.HasCaught()) {
-      FatalException(try_catch);
-    }
+  info.GetReturnValue().Set(Nan::New(obj->m_prefetch));
+}
+
+NAN_SETTER(ODBCResult::PrefetchSetter) {
+  Nan::HandleScope scope;
+
+  ODBCResult *obj = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  if (value->IsBoolean()) {
+    obj->m_prefetch = Nan::To<bool>(value).FromJust();
+  }
+}
+
+/*
+ * BindRowset
+ *
+ * Called from the thread pool. Binds the columns of the current result set
+ * to arrays of up to size rows and switches the statement to block fetching.
+ * With sets = 2 a second rowset is allocated for prefetching, see
+ * FetchRowset. Returns false, leaving the statement as it was, if the
+ * columns can not be bound.
+ */
+
+bool ODBCResult::BindRowset(SQLULEN size, int sets) {
+  DEBUG_PRINTF("ODBCResult::BindRowset size=%i sets=%i\n", size, sets);
+  SQLRETURN ret;
+  SQLULEN request = size;
+  
+  if (rowset != NULL || colCount <= 0) {
+    return rowset != NULL;
   }
   
-  data->objResult->Unref();
+  ColumnBuffer *buffers = ODBC::BindColumns(m_hSTMT, columns, colCount, &size, m_valueFlags, sets);
   
-  free(data);
-  free(work_req);
+  if (buffers == NULL) {
+    return false;
+  }
   
-  return;
+  rowStatus = (SQLUSMALLINT *) malloc(sets * size * sizeof(SQLUSMALLINT));
+  rowsetOffset = 0;
+  
+  ret = rowStatus ? SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_BIND_TYPE, (SQLPOINTER) SQL_BIND_BY_COLUMN, 0) : SQL_ERROR;
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) (intptr_t) size, 0);
+  }
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROWS_FETCHED_PTR, &rowsFetched[0], 0);
+  }
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_STATUS_PTR, rowStatus, 0);
+  }
+  if (SQL_SUCCEEDED(ret) && sets > 1) {
+    ret = SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_BIND_OFFSET_PTR, &rowsetOffset, 0);
+  }
+  
+  rowset = buffers;
+  rowsetSize = size;
+  rowsetRequest = request;
+  rowsetSets = sets;
+  rowsetNext = 0;
+  rowsetFilled = 0;
+  rowsFetched[0] = rowsFetched[1] = 0;
+  
+  if (!SQL_SUCCEEDED(ret)) {
+    DEBUG_PRINTF("ODBCResult::BindRowset - driver refused the rowset attributes\n");
+    UnbindRowset();
+    return false;
+  }
+  
+  return true;
 }
 
 /*
- * FetchSync
+ * UnbindRowset
+ *
+ * Puts the statement back into row at a time mode and releases the column
+ * arrays. Does nothing if no rowset is bound.
  */
 
-NAN_METHOD(ODBCResult::FetchSync) {
-  DEBUG_PRINTF("ODBCResult::FetchSync\n");
-  Nan::HandleScope scope;
+void ODBCResult::UnbindRowset() {
+  if (rowset == NULL) {
+    return;
+  }
   
-  ODBCResult* objResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
-
-  Local<Value> objError;
-  bool moreWork = true;
-  bool error = false;
-  int fetchMode = objResult->m_fetchMode;
+  DEBUG_PRINTF("ODBCResult::UnbindRowset m_hSTMT=%X\n", m_hSTMT);
   
-  if (info.Length() == 1 && info[0]->IsObject()) {
-    Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+  if (m_hSTMT) {
+    SQLFreeStmt(m_hSTMT, SQL_UNBIND);
+    SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) 1, 0);
+    SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROWS_FETCHED_PTR, NULL, 0);
+    SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_STATUS_PTR, NULL, 0);
     
-    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
-    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
-      fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    if (rowsetSets > 1) {
+      SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_BIND_OFFSET_PTR, NULL, 0);
     }
   }
   
-  SQLRETURN ret = SQLFetch(objResult->m_hSTMT);
+  ODBC::FreeColumnBuffers(rowset);
+  free(rowStatus);
+  
+  rowset = NULL;
+  rowStatus = NULL;
+  rowsetSize = 0;
+  rowsetSets = 1;
+  rowsetNext = 0;
+  rowsetFilled = 0;
+  rowsFetched[0] = rowsFetched[1] = 0;
+}
 
-  if (objResult->colCount == 0) {
-    objResult->columns = ODBC::GetColumns(
-      objResult->m_hSTMT, 
-      &objResult->colCount);
+/*
+ * FetchRowset
+ *
+ * Called from the thread pool to fetch the next row, or the next rowset
+ * into rowset set when two are bound. The other set is left alone, so the
+ * main thread can still be converting its rows. rowsetFilled tells which
+ * set holds the rows afterwards. Any other orientation than SQL_FETCH_NEXT
+ * moves a scrollable cursor with SQLFetchScroll.
+ */
+
+SQLRETURN ODBCResult::FetchRowset(int set, SQLSMALLINT orientation, SQLLEN offset) {
+  if (rowset != NULL && rowsetSets > 1) {
+    //every array of a set is the same number of bytes after the first set
+    rowsetOffset = (SQLLEN) (rowset[set * colCount].buffer - rowset[0].buffer);
+    
+    SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROWS_FETCHED_PTR, &rowsFetched[set], 0);
+    SQLSetStmtAttr(m_hSTMT, SQL_ATTR_ROW_STATUS_PTR, rowStatus + set * rowsetSize, 0);
   }
-  
-  //check to see if the result has no columns
-  if (objResult->colCount == 0) {
-    moreWork = false;
+  else {
+    set = 0;
+  }
+  
+  rowsetFilled = set;
+  
+  if (orientation != SQL_FETCH_NEXT) {
+    return SQLFetchScroll(m_hSTMT, orientation, offset);
+  }
+  
+  return SQLFetch(m_hSTMT);
+}
+
+/*
+ * RowsetError
+ *
+ * True when a row of rowset set could not be read.
+ */
+
+bool ODBCResult::RowsetError(int set) {
+  if (rowset == NULL) {
+    return false;
+  }
+  
+  for (SQLULEN row = 0; row < rowsFetched[set]; row++) {
+    if (rowStatus[set * rowsetSize + row] == SQL_ROW_ERROR) {
+      return true;
+    }
+  }
+  
+  return false;
+}
+
+/*
+ * RowsetComplete
+ *
+ * True when rowset set is full and all its rows were read, so more rows can
+ * follow it.
+ */
+
+bool ODBCResult::RowsetComplete(int set) {
+  if (rowset == NULL || rowsFetched[set] < rowsetSize) {
+    return false;
+  }
+  
+  return !RowsetError(set);
+}
+
+/*
+ * FetchRowData
+ *
+ * Called from the thread pool after a successful SQLFetch to read the first
+ * count columns of the current row into rowBuffer.
+ */
+
+SQLRETURN ODBCResult::FetchRowData(short count) {
+  if (rowBuffer == NULL) {
+    rowBuffer = ODBC::AllocRowBuffer(columns, colCount, m_valueFlags);
+    
+    if (rowBuffer == NULL) {
+      return SQL_ERROR;
+    }
+  }
+  
+  //the values of the previous row have been converted by now
+  ODBC::ShrinkRowBuffer(rowBuffer, colCount, scratch.maxLength);
+  
+  return ODBC::FetchRowData(m_hSTMT, columns, count, rowBuffer);
+}
+
+/*
+ * ReadLobChunk
+ *
+ * Called from the thread pool to read the next chunk of the column being
+ * streamed into lobBuffer. lobLength is set to the length of the chunk, or
+ * to SQL_NULL_DATA. Streaming stops at the last chunk, after which
+ * SQL_NO_DATA is returned.
+ */
+
+SQLRETURN ODBCResult::ReadLobChunk() {
+  SQLRETURN ret;
+  SQLLEN len = 0;
+  SQLLEN terCharLen = (lobCType == SQL_C_BINARY) ? 0 : 1;
+  
+  lobLength = 0;
+  
+  if (lobIndex == 0) {
+    return SQL_NO_DATA;
+  }
+  
+  if (lobBuffer == NULL) {
+    lobBuffer = (char *) malloc(LOB_CHUNK_SIZE);
+    
+    if (lobBuffer == NULL) {
+      lobIndex = 0;
+      return SQL_ERROR;
+    }
+  }
+  
+  ret = SQLGetData(m_hSTMT, lobIndex, lobCType, lobBuffer, LOB_CHUNK_SIZE, &len);
+  
+  DEBUG_PRINTF("ODBCResult::ReadLobChunk index=%i len=%i ret=%i\n", lobIndex, len, ret);
+  
+  //a full buffer means there is more to read
+  if (ret == SQL_SUCCESS_WITH_INFO && 
+      (len == SQL_NO_TOTAL || len > LOB_CHUNK_SIZE - terCharLen)) {
+    lobLength = LOB_CHUNK_SIZE - terCharLen;
+  }
+  else {
+    if (SQL_SUCCEEDED(ret)) {
+      lobLength = len;
+    }
+    
+    lobIndex = 0;
+  }
+  
+  return ret;
+}
+
+/*
+ * LobChunkValue
+ *
+ * The chunk read by ReadLobChunk as a Buffer, or null for a NULL value.
+ */
+
+Local<Value> ODBCResult::LobChunkValue() {
+  Nan::EscapableHandleScope scope;
+  
+  if (lobLength == SQL_NULL_DATA) {
+    return scope.Escape(Nan::Null());
+  }
+  
+  return scope.Escape(Nan::CopyBuffer(lobBuffer, lobLength).ToLocalChecked());
+}
+
+/*
+ * FetchColumnar
+ *
+ * Fetches every remaining row of the result set into the column vectors.
+ * Returns SQL_NO_DATA once all the rows are in. errorMessage is set when
+ * the vectors can not grow any further. Does not touch V8.
+ */
+
+SQLRETURN ODBCResult::FetchColumnar(const char** errorMessage) {
+  SQLRETURN ret;
+  
+  if (vectors == NULL) {
+    vectors = ODBC::AllocColumnVectors(columns, colCount, m_valueFlags);
+    
+    if (vectors == NULL) {
+      *errorMessage = COLUMNAR_MEMORY_ERROR;
+      return SQL_ERROR;
+    }
+  }
+  
+  while (true) {
+    ret = FetchRowset(0);
+    
+    if (!SQL_SUCCEEDED(ret)) {
+      return ret;
+    }
+    
+    if (rowset != NULL) {
+      for (SQLULEN row = 0; row < rowsFetched[0]; row++) {
+        if (rowStatus[row] == SQL_ROW_ERROR) {
+          return SQL_ERROR;
+        }
+        
+        if (!ODBC::AppendColumnVectors(columns, vectors, colCount, rowset, row, m_valueFlags)) {
+          *errorMessage = COLUMNAR_MEMORY_ERROR;
+          return SQL_ERROR;
+        }
+      }
+    }
+    else {
+      ret = FetchRowData(colCount);
+      
+      if (!SQL_SUCCEEDED(ret)) {
+        return ret;
+      }
+      
+      if (!ODBC::AppendColumnVectors(columns, vectors, colCount, rowBuffer, 0, m_valueFlags)) {
+        *errorMessage = COLUMNAR_MEMORY_ERROR;
+        return SQL_ERROR;
+      }
+    }
+  }
+}
+
+/*
+ * ColumnNames
+ *
+ * Returns the object keys of the current result set, creating them for the
+ * first row. Must be called from the main thread.
+ */
+
+Nan::Persistent<String>* ODBCResult::ColumnNames() {
+  if (columnNames == NULL) {
+    columnNames = ODBC::GetColumnNames(columns, colCount);
+  }
+  
+  return columnNames;
+}
+
+/*
+ * RowTemplate
+ *
+ * Returns the template for the rows of the current result set, looked up
+ * for the first row, or an empty one when there is none. Must be called from
+ * the main thread.
+ */
+
+Local<ObjectTemplate> ODBCResult::RowTemplate() {
+  if (!rowTemplateLoaded) {
+    rowTemplate.Reset(ODBC::GetRowTemplate(ColumnNames(), colCount));
+    rowTemplateLoaded = true;
+  }
+  
+  return Nan::New(rowTemplate);
+}
+
+/*
+ * LazyRowTemplate
+ *
+ * Same as RowTemplate for the rows of a FETCH_LAZY fetch.
+ */
+
+Local<ObjectTemplate> ODBCResult::LazyRowTemplate() {
+  if (!lazyTemplateLoaded) {
+    lazyTemplate.Reset(ODBC::GetLazyRowTemplate(ColumnNames(), colCount));
+    lazyTemplateLoaded = true;
+  }
+  
+  return Nan::New(lazyTemplate);
+}
+
+/*
+ * ReleaseColumns
+ *
+ * Frees the column metadata and every buffer that depends on it, at the end
+ * of a result set.
+ */
+
+void ODBCResult::ReleaseColumns() {
+  UnbindRowset();
+  
+  ODBC::FreeRowBuffer(rowBuffer, colCount);
+  rowBuffer = NULL;
+  
+  ODBC::FreeColumnVectors(vectors, colCount);
+  vectors = NULL;
+  
+  lobIndex = 0;
+  
+  ODBC::ShrinkScratchBuffer(&scratch);
+  
+  rowTemplate.Reset();
+  rowTemplateLoaded = false;
+  lazyTemplate.Reset();
+  lazyTemplateLoaded = false;
+  
+  ODBC::FreeColumnNames(columnNames, colCount);
+  columnNames = NULL;
+  
+  if (columnCache != NULL) {
+    //the statement keeps the metadata for its next executions
+    ODBC::ReleaseColumnCache(columnCache);
+    columnCache = NULL;
+    colCount = 0;
+  }
+  else if (colCount > 0) {
+    ODBC::FreeColumns(columns, &colCount);
+  }
+}
+
+/*
+ * LoadColumns
+ *
+ * Reads the column metadata of the current result set, or takes it from the
+ * cache of the prepared statement for the first result set of an execution.
+ */
+
+void ODBCResult::LoadColumns() {
+  if (columnCache != NULL) {
+    columns = columnCache->columns;
+    colCount = columnCache->colCount;
+  }
+  else {
+    columns = ODBC::GetColumns(m_hSTMT, &colCount);
+  }
+}
+
+/*
+ * Fetch
+ */
+
+NAN_METHOD(ODBCResult::Fetch) {
+  DEBUG_PRINTF("ODBCResult::Fetch\n");
+  Nan::HandleScope scope;
+  
+  ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  
+  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
+  
+  Local<Function> cb;
+   
+  //set the fetch mode to the default of this instance
+  data->fetchMode = objODBCResult->m_fetchMode;
+  
+  if (info.Length() == 1 && info[0]->IsFunction()) {
+    cb = Local<Function>::Cast(info[0]);
+  }
+  else if (info.Length() == 2 && info[0]->IsObject() && info[1]->IsFunction()) {
+    cb = Local<Function>::Cast(info[1]);  
+    
+    Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked(); 
+    
+    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
+    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
+      data->fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    }
+    
+    Local<String> lobStreamKey = Nan::New<String>(OPTION_LOB_STREAM);
+    if (Nan::HasOwnProperty(obj, lobStreamKey).IsJust() && Nan::Get(obj, lobStreamKey).ToLocalChecked()->IsBoolean()) {
+      data->lobStream = Nan::To<bool>(Nan::Get(obj, lobStreamKey).ToLocalChecked()).FromJust();
+    }
+  }
+  else {
+    return Nan::ThrowTypeError("ODBCResult::Fetch(): 1 or 2 arguments are required. The last argument must be a callback function.");
+  }
+  
+  data->cb = new Nan::Callback(cb);
+  
+  data->objResult = objODBCResult;
+  work_req->data = data;
+  
+  uv_queue_work(
+    uv_default_loop(), 
+    work_req, 
+    UV_Fetch, 
+    (uv_after_work_cb)UV_AfterFetch);
+
+  objODBCResult->Ref();
+
+  info.GetReturnValue().Set(Nan::Undefined());
+}
+
+void ODBCResult::UV_Fetch(uv_work_t* work_req) {
+  DEBUG_PRINTF("ODBCResult::UV_Fetch\n");
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  //moving to the next row ends any stream of the current one
+  self->lobIndex = 0;
+  
+  //back to one row at a time after fetchMany()
+  self->UnbindRowset();
+  
+  data->result = SQLFetch(self->m_hSTMT);
+  
+  if (self->colCount == 0) {
+    self->LoadColumns();
+  }
+  
+  //read the whole row here so the main thread only builds the V8 values
+  if (SQL_SUCCEEDED(data->result) && self->colCount > 0) {
+    //the last column can be streamed instead, starting with its first chunk
+    if (data->lobStream) {
+      self->lobCType = ODBC::GetLobCType(self->columns[self->colCount - 1]);
+      data->lobStream = (self->lobCType != 0);
+    }
+    
+    if (data->lobStream) {
+      data->result = self->FetchRowData(self->colCount - 1);
+      
+      if (SQL_SUCCEEDED(data->result)) {
+        self->lobIndex = self->columns[self->colCount - 1].index;
+        data->result = self->ReadLobChunk();
+      }
+    }
+    else {
+      data->result = self->FetchRowData(self->colCount);
+    }
+  }
+}
+
+void ODBCResult::UV_AfterFetch(uv_work_t* work_req, int status) {
+  DEBUG_PRINTF("ODBCResult::UV_AfterFetch\n");
+  Nan::HandleScope scope;
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  SQLRETURN ret = data->result;
+  //TODO: we should probably define this on the work data so we
+  //don't have to keep creating it?
+  Local<Value> objError;
+  bool moreWork = true;
+  bool error = false;
+  
+  //check to see if the result has no columns
+  if (data->objResult->colCount == 0) {
+    //this means
+    moreWork = false;
   }
   //check to see if there was an error
   else if (ret == SQL_ERROR)  {
@@ -359,7 +937,7 @@ NAN_METHOD(ODBCResult::FetchSync) {
     
     objError = ODBC::GetSQLError(
       SQL_HANDLE_STMT, 
-      objResult->m_hSTMT,
+      data->objResult->m_hSTMT,
       (char *) "Error in ODBCResult::UV_AfterFetch");
   }
   //check to see if we are at the end of the recordset
@@ -368,30 +946,175 @@ NAN_METHOD(ODBCResult::FetchSync) {
   }
 
   if (moreWork) {
-    Local<Value> data;
+    Local<Value> info[3];
     
-    if (fetchMode == FETCH_ARRAY) {
-      data = ODBC::GetRecordArray(
-        objResult->m_hSTMT,
-        objResult->columns,
-        &objResult->colCount,
-        objResult->buffer,
-        objResult->bufferLength);
+    //a streamed last column is filled in with its first chunk below
+    short colCount = data->objResult->colCount - (data->lobStream ? 1 : 0);
+
+    info[0] = Nan::Null();
+    info[2] = Nan::False();
+    if (data->fetchMode == FETCH_ARRAY) {
+      info[1] = ODBC::GetBufferedRecordArray(
+        data->objResult->columns,
+        &colCount,
+        data->objResult->rowBuffer,
+        0,
+        data->objResult->m_valueFlags,
+        data->objResult->dictionary);
+      
+      if (data->lobStream) {
+        info[2] = Nan::New(colCount);
+        Nan::Set(info[1].As<Object>(), info[2],
+                 data->objResult->LobChunkValue());
+      }
     }
     else {
-      data = ODBC::GetRecordTuple(
-        objResult->m_hSTMT,
-        objResult->columns,
-        &objResult->colCount,
-        objResult->buffer,
-        objResult->bufferLength);
+      info[1] = ODBC::GetBufferedRecordTuple(
+        data->objResult->columns,
+        &colCount,
+        data->objResult->rowBuffer,
+        0,
+        data->objResult->ColumnNames(),
+        data->objResult->RowTemplate(),
+        data->objResult->m_valueFlags,
+        data->objResult->dictionary);
+      
+      if (data->lobStream) {
+        info[2] = Nan::New(data->objResult->ColumnNames()[colCount]);
+        Nan::Set(info[1].As<Object>(), info[2],
+                 data->objResult->LobChunkValue());
+      }
     }
     
-    info.GetReturnValue().Set(data);
+    //the key of the streamed column, or false, tells lib/odbc.js which value
+    //to turn into a stream; with repeated labels it is not the last key
+
+    Nan::TryCatch try_catch;
+
+    data->cb->Call(3, info);
+    delete data->cb;
+
+    if (try_catch.HasCaught()) {
+      FatalException(try_catch);
+    }
   }
   else {
-    ODBC::FreeColumns(objResult->columns, &objResult->colCount);
-
+    data->objResult->ReleaseColumns();
+    
+    Local<Value> info[2];
+    
+    //if there was an error, pass that as arg[0] otherwise Null
+    if (error) {
+      info[0] = objError;
+    }
+    else {
+      info[0] = Nan::Null();
+    }
+    
+    info[1] = Nan::Null();
+
+    Nan::TryCatch try_catch;
+
+    data->cb->Call(2, info);
+    delete data->cb;
+
+    if (try_catch.HasCaught()) {
+      FatalException(try_catch);
+    }
+  }
+  
+  data->objResult->Unref();
+  
+  free(data);
+  free(work_req);
+  
+  return;
+}
+
+/*
+ * FetchSync
+ */
+
+NAN_METHOD(ODBCResult::FetchSync) {
+  DEBUG_PRINTF("ODBCResult::FetchSync\n");
+  Nan::HandleScope scope;
+  
+  ODBCResult* objResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+
+  Local<Value> objError;
+  bool moreWork = true;
+  bool error = false;
+  int fetchMode = objResult->m_fetchMode;
+  
+  if (info.Length() == 1 && info[0]->IsObject()) {
+    Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+    
+    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
+    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
+      fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    }
+  }
+  
+  //moving to the next row ends any stream of the current one
+  objResult->lobIndex = 0;
+  
+  //back to one row at a time after fetchMany()
+  objResult->UnbindRowset();
+  
+  SQLRETURN ret = SQLFetch(objResult->m_hSTMT);
+
+  if (objResult->colCount == 0) {
+    objResult->LoadColumns();
+  }
+  
+  //check to see if the result has no columns
+  if (objResult->colCount == 0) {
+    moreWork = false;
+  }
+  //check to see if there was an error
+  else if (ret == SQL_ERROR)  {
+    moreWork = false;
+    error = true;
+    
+    objError = ODBC::GetSQLError(
+      SQL_HANDLE_STMT, 
+      objResult->m_hSTMT,
+      (char *) "Error in ODBCResult::UV_AfterFetch");
+  }
+  //check to see if we are at the end of the recordset
+  else if (ret == SQL_NO_DATA) {
+    moreWork = false;
+  }
+
+  if (moreWork) {
+    Local<Value> data;
+    
+    if (fetchMode == FETCH_ARRAY) {
+      data = ODBC::GetRecordArray(
+        objResult->m_hSTMT,
+        objResult->columns,
+        &objResult->colCount,
+        &objResult->scratch,
+        objResult->m_valueFlags,
+        objResult->dictionary);
+    }
+    else {
+      data = ODBC::GetRecordTuple(
+        objResult->m_hSTMT,
+        objResult->columns,
+        &objResult->colCount,
+        &objResult->scratch,
+        objResult->ColumnNames(),
+        objResult->RowTemplate(),
+        objResult->m_valueFlags,
+        objResult->dictionary);
+    }
+    
+    info.GetReturnValue().Set(data);
+  }
+  else {
+    objResult->ReleaseColumns();
+
     //if there was an error, pass that as arg[0] otherwise Null
     if (error) {
       Nan::ThrowError(objError);
@@ -405,44 +1128,715 @@ NAN_METHOD(ODBCResult::FetchSync) {
 }
 
 /*
- * FetchAll
+ * ReadLob
+ *
+ * Reads the next chunk of the column streamed by fetch({ lobStream: true })
+ * and calls back with it as a Buffer, or with null after the last chunk.
+ */
+
+NAN_METHOD(ODBCResult::ReadLob) {
+  DEBUG_PRINTF("ODBCResult::ReadLob\n");
+  Nan::HandleScope scope;
+  
+  REQ_FUN_ARG(0, cb);
+  
+  ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  MEMCHECK( work_req ) ;
+  
+  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
+  MEMCHECK( data ) ;
+  
+  data->cb = new Nan::Callback(cb);
+  data->objResult = objODBCResult;
+  work_req->data = data;
+  
+  uv_queue_work(
+    uv_default_loop(), 
+    work_req, 
+    UV_ReadLob, 
+    (uv_after_work_cb)UV_AfterReadLob);
+
+  objODBCResult->Ref();
+
+  info.GetReturnValue().Set(Nan::Undefined());
+}
+
+void ODBCResult::UV_ReadLob(uv_work_t* work_req) {
+  DEBUG_PRINTF("ODBCResult::UV_ReadLob\n");
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  data->result = data->objResult->ReadLobChunk();
+}
+
+void ODBCResult::UV_AfterReadLob(uv_work_t* work_req, int status) {
+  DEBUG_PRINTF("ODBCResult::UV_AfterReadLob\n");
+  Nan::HandleScope scope;
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  Local<Value> info[2];
+  
+  if (data->result == SQL_NO_DATA) {
+    info[0] = Nan::Null();
+    info[1] = Nan::Null();
+  }
+  else if (!SQL_SUCCEEDED(data->result)) {
+    info[0] = ODBC::GetSQLError(
+      SQL_HANDLE_STMT, 
+      data->objResult->m_hSTMT,
+      (char *) "[node-informixdb] Error in ODBCResult::UV_AfterReadLob");
+    info[1] = Nan::Null();
+  }
+  else {
+    info[0] = Nan::Null();
+    info[1] = data->objResult->LobChunkValue();
+  }
+  
+  Nan::TryCatch try_catch;
+  
+  data->cb->Call(2, info);
+  delete data->cb;
+  
+  if (try_catch.HasCaught()) {
+    FatalException(try_catch);
+  }
+  
+  data->objResult->Unref();
+  
+  free(data);
+  free(work_req);
+}
+
+/*
+ * PushFetchedRows
+ *
+ * Adds the rows read by the last pass on the thread pool, from rowset set
+ * or from the row buffer, to data->rows. Returns false, with the error in
+ * data->objError, when a row of the rowset could not be read.
+ */
+
+bool ODBCResult::PushFetchedRows(fetch_work_data* data, int set) {
+  Local<Array> rows = Nan::New(data->rows);
+  
+  if (rowset != NULL) {
+    ColumnBuffer *buffers = rowset + set * colCount;
+    Local<Value> lazyRowset;
+    
+    //FETCH_LAZY rows keep a copy of the rowset and convert nothing yet; the
+    //string dictionary goes with the result, so with dedupeStrings the rows
+    //are converted now
+    if (data->fetchMode == FETCH_LAZY && rowsFetched[set] > 0 && dictionary == NULL &&
+        !LazyRowTemplate().IsEmpty()) {
+      lazyRowset = ODBC::NewLazyRowset(columns, colCount, buffers, rowsFetched[set], m_valueFlags);
+    }
+    
+    for (SQLULEN row = 0; row < rowsFetched[set]; row++) {
+      if (rowStatus[set * rowsetSize + row] == SQL_ROW_ERROR) {
+        data->errorCount++;
+        
+        data->objError.Reset(ODBC::GetSQLError(
+          SQL_HANDLE_STMT, 
+          m_hSTMT,
+          (char *) "[node-informixdb] Error in ODBCResult::PushFetchedRows"
+        ));
+        
+        return false;
+      }
+      
+      if (data->fetchMode == FETCH_ARRAY) {
+        Nan::Set(rows,
+          Nan::New(data->count), 
+          ODBC::GetBufferedRecordArray(
+            columns,
+            &colCount,
+            buffers,
+            row,
+            m_valueFlags,
+            dictionary)
+        );
+      }
+      else if (!lazyRowset.IsEmpty() && node::Buffer::HasInstance(lazyRowset)) {
+        Nan::Set(rows,
+          Nan::New(data->count), 
+          ODBC::GetLazyRecord(LazyRowTemplate(), lazyRowset, row)
+        );
+      }
+      else {
+        Nan::Set(rows,
+          Nan::New(data->count), 
+          ODBC::GetBufferedRecordTuple(
+            columns,
+            &colCount,
+            buffers,
+            row,
+            ColumnNames(),
+            RowTemplate(),
+            m_valueFlags,
+            dictionary)
+        );
+      }
+      data->count++;
+    }
+    
+    return true;
+  }
+  
+  if (data->fetchMode == FETCH_ARRAY) {
+    Nan::Set(rows,
+      Nan::New(data->count), 
+      ODBC::GetBufferedRecordArray(
+        columns,
+        &colCount,
+        rowBuffer,
+        0,
+        m_valueFlags,
+        dictionary)
+    );
+  }
+  else {
+    Nan::Set(rows,
+      Nan::New(data->count), 
+      ODBC::GetBufferedRecordTuple(
+        columns,
+        &colCount,
+        rowBuffer,
+        0,
+        ColumnNames(),
+        RowTemplate(),
+        m_valueFlags,
+        dictionary)
+    );
+  }
+  data->count++;
+  
+  return true;
+}
+
+/*
+ * FetchMany
+ *
+ * Reads up to count rows. When the columns can be bound they are all read
+ * with one SQLFetch of a rowset of count rows, otherwise one row per pass on
+ * the thread pool. The callback gets the rows and whether the result set is
+ * exhausted.
+ */
+
+NAN_METHOD(ODBCResult::FetchMany) {
+  DEBUG_PRINTF("ODBCResult::FetchMany\n");
+  
+  FetchScroll(info, SQL_FETCH_NEXT, "FetchMany");
+}
+
+/*
+ * FetchAbsolute
+ *
+ * Reads up to count rows of a scrollable cursor starting at row position,
+ * 1 for the first row and -1 for the last one, as fetchMany does.
+ */
+
+NAN_METHOD(ODBCResult::FetchAbsolute) {
+  DEBUG_PRINTF("ODBCResult::FetchAbsolute\n");
+  
+  FetchScroll(info, SQL_FETCH_ABSOLUTE, "FetchAbsolute");
+}
+
+/*
+ * FetchRelative
+ *
+ * Reads up to count rows of a scrollable cursor starting offset rows from
+ * the first row of the last fetch, as fetchMany does.
+ */
+
+NAN_METHOD(ODBCResult::FetchRelative) {
+  DEBUG_PRINTF("ODBCResult::FetchRelative\n");
+  
+  FetchScroll(info, SQL_FETCH_RELATIVE, "FetchRelative");
+}
+
+/*
+ * FetchScroll
+ *
+ * Queues the work of fetchMany, fetchAbsolute and fetchRelative. The first
+ * fetch moves the cursor as orientation asks and the rows that follow it are
+ * read with SQLFetch when they do not fit in one rowset. method names the
+ * calling method in the error messages.
+ */
+
+void ODBCResult::FetchScroll(const Nan::FunctionCallbackInfo<v8::Value>& info, SQLSMALLINT orientation,
+                             const char* method) {
+  Nan::HandleScope scope;
+  char message[256];
+  
+  ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  //the position comes before the arguments of fetchMany
+  int first = (orientation == SQL_FETCH_NEXT) ? 0 : 1;
+  int argc = info.Length() - first;
+  
+  Local<Function> cb;
+  Local<Object> obj;
+  
+  if (first > 0 && (info.Length() < 1 || !info[0]->IsInt32())) {
+    snprintf(message, sizeof(message), "ODBCResult::%s(): the first argument must be the row position.", method);
+    return Nan::ThrowTypeError(message);
+  }
+  
+  if (argc == 2 && info[first]->IsInt32() && info[first + 1]->IsFunction()) {
+    cb = Local<Function>::Cast(info[first + 1]);
+  }
+  else if (argc == 3 && info[first]->IsInt32() && info[first + 1]->IsObject() && info[first + 2]->IsFunction()) {
+    cb = Local<Function>::Cast(info[first + 2]);
+    obj = Nan::To<v8::Object>(info[first + 1]).ToLocalChecked();
+  }
+  else if (first > 0) {
+    snprintf(message, sizeof(message), "ODBCResult::%s(): 3 or 4 arguments are required. The first arguments must be the row position and the number of rows and the last a callback function.", method);
+    return Nan::ThrowTypeError(message);
+  }
+  else {
+    return Nan::ThrowTypeError("ODBCResult::FetchMany(): 2 or 3 arguments are required. The first argument must be the number of rows and the last a callback function.");
+  }
+  
+  int count = Nan::To<int32_t>(info[first]).FromJust();
+  
+  if (count < 1 || count > MAX_ROWSET_SIZE) {
+    snprintf(message, sizeof(message), "ODBCResult::%s(): the number of rows must be between 1 and 65535.", method);
+    return Nan::ThrowRangeError(message);
+  }
+  
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  
+  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
+  
+  MEMCHECK( work_req );
+  MEMCHECK( data );
+  
+  data->fetchMode = objODBCResult->m_fetchMode;
+  data->rowsetSize = count;
+  data->limit = count;
+  data->orientation = orientation;
+  data->offset = first > 0 ? Nan::To<int32_t>(info[0]).FromJust() : 0;
+  
+  if (!obj.IsEmpty()) {
+    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
+    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
+      data->fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    }
+  }
+  
+  //rows are always returned one by one
+  if (data->fetchMode == FETCH_COLUMNAR) {
+    data->fetchMode = FETCH_OBJECT;
+  }
+  
+  data->rows.Reset(Nan::New<Array>());
+  data->errorCount = 0;
+  data->count = 0;
+  data->objError.Reset(Nan::New<Object>());
+  
+  data->cb = new Nan::Callback(cb);
+  data->objResult = objODBCResult;
+  
+  work_req->data = data;
+  
+  uv_queue_work(uv_default_loop(),
+    work_req, 
+    UV_FetchMany, 
+    (uv_after_work_cb)UV_AfterFetchMany);
+
+  data->objResult->Ref();
+
+  info.GetReturnValue().Set(Nan::Undefined());
+}
+
+void ODBCResult::UV_FetchMany(uv_work_t* work_req) {
+  DEBUG_PRINTF("ODBCResult::UV_FetchMany\n");
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  self->lobIndex = 0;
+  
+  if (self->colCount == 0) {
+    self->LoadColumns();
+  }
+  
+  if (self->colCount == 0) {
+    data->result = SQL_NO_DATA;
+    return;
+  }
+  
+  SQLSMALLINT orientation = SQL_FETCH_NEXT;
+  
+  //on the first pass bind a rowset of the size of the batch, replacing one
+  //bound for a batch of another size, and move a scrollable cursor
+  if (data->rowsetSize > 0) {
+    if (self->rowset != NULL && self->rowsetRequest != (SQLULEN) data->rowsetSize) {
+      self->UnbindRowset();
+    }
+    if (data->rowsetSize > 1) {
+      self->BindRowset(data->rowsetSize);
+    }
+    data->rowsetSize = 0;
+    orientation = data->orientation;
+  }
+  
+  data->result = self->FetchRowset(0, orientation, data->offset);
+  
+  if (SQL_SUCCEEDED(data->result) && self->rowset == NULL) {
+    data->result = self->FetchRowData(self->colCount);
+  }
+}
+
+void ODBCResult::UV_AfterFetchMany(uv_work_t* work_req, int status) {
+  DEBUG_PRINTF("ODBCResult::UV_AfterFetchMany\n");
+  Nan::HandleScope scope;
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  bool doMoreWork = false;
+  bool exhausted = false;
+  
+  if (data->result == SQL_ERROR) {
+    data->errorCount++;
+    
+    data->objError.Reset(ODBC::GetSQLError(
+      SQL_HANDLE_STMT, 
+      self->m_hSTMT,
+      (char *) "[node-informixdb] Error in ODBCResult::UV_AfterFetchMany"
+    ));
+  }
+  else if (data->result == SQL_NO_DATA) {
+    exhausted = true;
+  }
+  else if (self->PushFetchedRows(data, self->rowsetFilled)) {
+    //a rowset that is not full is the last one
+    if (self->rowset != NULL) {
+      exhausted = (self->rowsFetched[self->rowsetFilled] < self->rowsetSize);
+    }
+    else {
+      doMoreWork = (data->count < data->limit);
+    }
+  }
+  
+  if (doMoreWork) {
+    uv_queue_work(
+      uv_default_loop(),
+      work_req, 
+      UV_FetchMany, 
+      (uv_after_work_cb)UV_AfterFetchMany);
+    
+    return;
+  }
+  
+  Local<Value> info[3];
+  
+  if (data->errorCount > 0) {
+    info[0] = Nan::New(data->objError);
+  }
+  else {
+    info[0] = Nan::Null();
+  }
+  
+  info[1] = Nan::New(data->rows);
+  info[2] = Nan::New(exhausted || data->errorCount > 0);
+  
+  //a scrollable cursor can still move back from the end
+  if ((exhausted || data->errorCount > 0) && data->orientation == SQL_FETCH_NEXT) {
+    self->ReleaseColumns();
+  }
+  
+  Nan::TryCatch try_catch;
+  
+  data->cb->Call(3, info);
+  delete data->cb;
+  data->rows.Reset();
+  data->objError.Reset();
+  
+  if (try_catch.HasCaught()) {
+    FatalException(try_catch);
+  }
+  
+  free(data);
+  free(work_req);
+  
+  self->Unref(); 
+}
+
+/*
+ * FetchAll
+ */
+
+NAN_METHOD(ODBCResult::FetchAll) {
+  DEBUG_PRINTF("ODBCResult::FetchAll\n");
+  Nan::HandleScope scope;
+  
+  ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  
+  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
+  
+  Local<Function> cb;
+  
+  data->fetchMode = objODBCResult->m_fetchMode;
+  data->rowsetSize = objODBCResult->m_rowsetSize;
+  data->prefetch = objODBCResult->m_prefetch;
+  
+  if (info.Length() == 1 && info[0]->IsFunction()) {
+    cb = Local<Function>::Cast(info[0]);
+  }
+  else if (info.Length() == 2 && info[0]->IsObject() && info[1]->IsFunction()) {
+    cb = Local<Function>::Cast(info[1]);  
+    
+    Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+    
+    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
+    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
+      data->fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    }
+    
+    Local<String> rowsetSizeKey = Nan::New<String>(OPTION_ROWSET_SIZE);
+    if (Nan::HasOwnProperty(obj, rowsetSizeKey).IsJust() && Nan::Get(obj, rowsetSizeKey).ToLocalChecked()->IsInt32()) {
+      data->rowsetSize = Nan::To<int32_t>(Nan::Get(obj, rowsetSizeKey).ToLocalChecked()).FromJust();
+    }
+    
+    Local<String> prefetchKey = Nan::New<String>(OPTION_PREFETCH);
+    if (Nan::HasOwnProperty(obj, prefetchKey).IsJust() && Nan::Get(obj, prefetchKey).ToLocalChecked()->IsBoolean()) {
+      data->prefetch = Nan::To<bool>(Nan::Get(obj, prefetchKey).ToLocalChecked()).FromJust();
+    }
+  }
+  else {
+    Nan::ThrowTypeError("ODBCResult::FetchAll(): 1 or 2 arguments are required. The last argument must be a callback function.");
+  }
+  
+  //lazy rows are copied from a bound rowset, so fetch in blocks
+  if (data->fetchMode == FETCH_LAZY && data->rowsetSize <= 1) {
+    data->rowsetSize = LAZY_ROWSET_SIZE;
+  }
+  
+  data->rows.Reset(Nan::New<Array>());
+  data->errorCount = 0;
+  data->count = 0;
+  data->objError.Reset(Nan::New<Object>());
+  
+  data->cb = new Nan::Callback(cb);
+  data->objResult = objODBCResult;
+  
+  work_req->data = data;
+  
+  uv_queue_work(uv_default_loop(),
+    work_req, 
+    UV_FetchAll, 
+    (uv_after_work_cb)UV_AfterFetchAll);
+
+  data->objResult->Ref();
+
+  info.GetReturnValue().Set(Nan::Undefined());
+}
+
+void ODBCResult::UV_FetchAll(uv_work_t* work_req) {
+  DEBUG_PRINTF("ODBCResult::UV_FetchAll\n");
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  if (self->colCount == 0) {
+    self->LoadColumns();
+  }
+  
+  //on the first pass try to switch to block fetching; results with columns
+  //that can not be bound keep fetching one row per pass
+  if (data->rowsetSize > 1) {
+    self->BindRowset(data->rowsetSize, (data->prefetch && data->fetchMode != FETCH_COLUMNAR) ? 2 : 1);
+    data->rowsetSize = 1;
+  }
+  
+  //in columnar mode the whole result set is read in this one pass
+  if (data->fetchMode == FETCH_COLUMNAR) {
+    if (self->colCount > 0) {
+      data->result = self->FetchColumnar(&data->errorMessage);
+    }
+    
+    return;
+  }
+  
+  data->result = self->FetchRowset(self->rowsetNext);
+  
+  //read the whole row here so the main thread only builds the V8 values
+  if (SQL_SUCCEEDED(data->result) && self->rowset == NULL && self->colCount > 0) {
+    data->result = self->FetchRowData(self->colCount);
+  }
+}
+
+void ODBCResult::UV_AfterFetchAll(uv_work_t* work_req, int status) {
+  DEBUG_PRINTF("ODBCResult::UV_AfterFetchAll\n");
+  Nan::HandleScope scope;
+  
+  fetch_work_data* data = (fetch_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  bool doMoreWork = true;
+  
+  //a rowset converted while this one was fetched failed, so stop here
+  if (data->errorCount > 0) {
+    doMoreWork = false;
+  }
+  //check to see if the result set has columns
+  else if (self->colCount == 0) {
+    //this most likely means that the query was something like
+    //'insert into ....'
+    doMoreWork = false;
+  }
+  //check to see if there was an error
+  else if (data->result == SQL_ERROR)  {
+    data->errorCount++;
+    
+    if (data->errorMessage != NULL) {
+      data->objError.Reset(Nan::Error(data->errorMessage));
+    }
+    else {
+      data->objError.Reset(ODBC::GetSQLError(
+        SQL_HANDLE_STMT, 
+        self->m_hSTMT,
+        (char *) "[node-informixdb] Error in ODBCResult::UV_AfterFetchAll"
+      ));
+    }
+    
+    doMoreWork = false;
+  }
+  //check to see if we are at the end of the recordset
+  else if (data->result == SQL_NO_DATA) {
+    doMoreWork = false;
+  }
+  else if (data->fetchMode == FETCH_COLUMNAR) {
+    doMoreWork = false;
+  }
+  else {
+    int set = self->rowsetFilled;
+    bool prefetching = false;
+    
+    //fetch the next rowset into the other set while this one is converted,
+    //but only when no row of this one failed: the diagnostics of a failed
+    //row are read from the statement, which the next fetch would be using
+    if (data->prefetch && self->rowsetSets > 1 && !self->RowsetError(set) &&
+        self->RowsetComplete(set)) {
+      self->rowsetNext = set ^ 1;
+      
+      uv_queue_work(
+        uv_default_loop(),
+        work_req, 
+        UV_FetchAll, 
+        (uv_after_work_cb)UV_AfterFetchAll);
+      
+      prefetching = true;
+    }
+    
+    doMoreWork = self->PushFetchedRows(data, set);
+    
+    //the pass already queued ends the fetch if this one failed
+    if (prefetching) {
+      return;
+    }
+  }
+  
+  if (doMoreWork) {
+    //Go back to the thread pool and fetch more data!
+    uv_queue_work(
+      uv_default_loop(),
+      work_req, 
+      UV_FetchAll, 
+      (uv_after_work_cb)UV_AfterFetchAll);
+  }
+  else {
+    Local<Value> info[2];
+    
+    if (data->errorCount > 0) {
+      info[0] = Nan::New(data->objError);
+    }
+    else {
+      info[0] = Nan::Null();
+    }
+    
+    if (data->fetchMode == FETCH_COLUMNAR && data->errorCount == 0 && self->vectors != NULL) {
+      info[1] = ODBC::GetColumnVectorsArray(self->columns, self->vectors, self->colCount);
+    }
+    else {
+      info[1] = Nan::New(data->rows);
+    }
+    
+    self->ReleaseColumns();
+
+    Nan::TryCatch try_catch;
+
+    data->cb->Call(2, info);
+    delete data->cb;
+    data->rows.Reset();
+    data->objError.Reset();
+
+    if (try_catch.HasCaught()) {
+      FatalException(try_catch);
+    }
+
+    //TODO: Do we need to free self->rows somehow?
+    free(data);
+    free(work_req);
+
+    self->Unref(); 
+  }
+}
+
+/*
+ * FetchArrow
+ *
+ * Fetches every remaining row like fetchAll in FETCH_COLUMNAR mode and
+ * passes the callback a Buffer with the rows encoded as an Arrow IPC stream.
+ * No JavaScript value is created per row or per value.
  */
 
-NAN_METHOD(ODBCResult::FetchAll) {
-  DEBUG_PRINTF("ODBCResult::FetchAll\n");
+NAN_METHOD(ODBCResult::FetchArrow) {
+  DEBUG_PRINTF("ODBCResult::FetchArrow\n");
   Nan::HandleScope scope;
   
   ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
   
-  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
-  
-  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
-  
   Local<Function> cb;
-  
-  data->fetchMode = objODBCResult->m_fetchMode;
+  int rowsetSize = objODBCResult->m_rowsetSize;
   
   if (info.Length() == 1 && info[0]->IsFunction()) {
     cb = Local<Function>::Cast(info[0]);
   }
   else if (info.Length() == 2 && info[0]->IsObject() && info[1]->IsFunction()) {
-    cb = Local<Function>::Cast(info[1]);  
+    cb = Local<Function>::Cast(info[1]);
     
     Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked();
     
-    Local<String> fetchModeKey = Nan::New<String>(OPTION_FETCH_MODE);
-    if (Nan::HasOwnProperty(obj, fetchModeKey).IsJust() && Nan::Get(obj, fetchModeKey).ToLocalChecked()->IsInt32()) {
-      data->fetchMode = Nan::To<Uint32>(Nan::Get(obj, fetchModeKey).ToLocalChecked()).ToLocalChecked()->Value();
+    Local<String> rowsetSizeKey = Nan::New<String>(OPTION_ROWSET_SIZE);
+    if (Nan::HasOwnProperty(obj, rowsetSizeKey).FromMaybe(false) && Nan::Get(obj, rowsetSizeKey).ToLocalChecked()->IsInt32()) {
+      rowsetSize = Nan::To<int32_t>(Nan::Get(obj, rowsetSizeKey).ToLocalChecked()).FromJust();
     }
   }
   else {
-    Nan::ThrowTypeError("ODBCResult::FetchAll(): 1 or 2 arguments are required. The last argument must be a callback function.");
+    return Nan::ThrowTypeError("ODBCResult::FetchArrow(): 1 or 2 arguments are required. The last argument must be a callback function.");
   }
   
-  data->rows.Reset(Nan::New<Array>());
-  data->errorCount = 0;
-  data->count = 0;
-  data->objError.Reset(Nan::New<Object>());
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  MEMCHECK( work_req );
+  
+  fetch_work_data* data = (fetch_work_data *) calloc(1, sizeof(fetch_work_data));
+  MEMCHECK( data );
+  
+  data->fetchMode = FETCH_COLUMNAR;
+  data->rowsetSize = rowsetSize;
+  data->arrow = NULL;
+  data->arrowLength = 0;
   
   data->cb = new Nan::Callback(cb);
   data->objResult = objODBCResult;
@@ -451,125 +1845,396 @@ NAN_METHOD(ODBCResult::FetchAll) {
   
   uv_queue_work(uv_default_loop(),
     work_req, 
-    UV_FetchAll, 
-    (uv_after_work_cb)UV_AfterFetchAll);
+    UV_FetchArrow, 
+    (uv_after_work_cb)UV_AfterFetchArrow);
 
   data->objResult->Ref();
 
   info.GetReturnValue().Set(Nan::Undefined());
 }
 
-void ODBCResult::UV_FetchAll(uv_work_t* work_req) {
-  DEBUG_PRINTF("ODBCResult::UV_FetchAll\n");
+void ODBCResult::UV_FetchArrow(uv_work_t* work_req) {
+  DEBUG_PRINTF("ODBCResult::UV_FetchArrow\n");
   
   fetch_work_data* data = (fetch_work_data *)(work_req->data);
   
-  data->result = SQLFetch(data->objResult->m_hSTMT);
- }
+  ODBCResult* self = data->objResult->self();
+  
+  if (self->colCount == 0) {
+    self->LoadColumns();
+  }
+  
+  if (data->rowsetSize > 1) {
+    self->BindRowset(data->rowsetSize);
+  }
+  
+  data->result = SQL_NO_DATA;
+  
+  if (self->colCount > 0) {
+    data->result = self->FetchColumnar(&data->errorMessage);
+  }
+  
+  //encode here too, the main thread only wraps the stream in a Buffer
+  if (data->result == SQL_NO_DATA) {
+    data->arrow = ODBC::GetArrowStream(self->columns, self->vectors, self->colCount, &data->arrowLength);
+    
+    if (data->arrow == NULL) {
+      data->errorMessage = COLUMNAR_MEMORY_ERROR;
+      data->result = SQL_ERROR;
+    }
+  }
+}
 
-void ODBCResult::UV_AfterFetchAll(uv_work_t* work_req, int status) {
-  DEBUG_PRINTF("ODBCResult::UV_AfterFetchAll\n");
+void ODBCResult::UV_AfterFetchArrow(uv_work_t* work_req, int status) {
+  DEBUG_PRINTF("ODBCResult::UV_AfterFetchArrow\n");
   Nan::HandleScope scope;
   
   fetch_work_data* data = (fetch_work_data *)(work_req->data);
   
   ODBCResult* self = data->objResult->self();
   
-  bool doMoreWork = true;
+  Local<Value> info[2];
   
-  if (self->colCount == 0) {
-    self->columns = ODBC::GetColumns(self->m_hSTMT, &self->colCount);
+  if (data->arrow == NULL) {
+    if (data->errorMessage != NULL) {
+      info[0] = Nan::Error(data->errorMessage);
+    }
+    else {
+      info[0] = ODBC::GetSQLError(
+        SQL_HANDLE_STMT, 
+        self->m_hSTMT,
+        (char *) "[node-informixdb] Error in ODBCResult::UV_AfterFetchArrow"
+      );
+    }
+    
+    info[1] = Nan::Null();
+  }
+  else {
+    info[0] = Nan::Null();
+    info[1] = ODBC::NewExternalBuffer(data->arrow, data->arrowLength);
+    data->arrow = NULL;
   }
   
-  //check to see if the result set has columns
-  if (self->colCount == 0) {
-    //this most likely means that the query was something like
-    //'insert into ....'
-    doMoreWork = false;
+  self->ReleaseColumns();
+  
+  Nan::TryCatch try_catch;
+  
+  data->cb->Call(2, info);
+  delete data->cb;
+  
+  if (try_catch.HasCaught()) {
+    FatalException(try_catch);
   }
-  //check to see if there was an error
-  else if (data->result == SQL_ERROR)  {
-    data->errorCount++;
-    
-    data->objError.Reset(ODBC::GetSQLError(
-      SQL_HANDLE_STMT, 
-      self->m_hSTMT,
-      (char *) "[node-informixdb] Error in ODBCResult::UV_AfterFetchAll"
-    ));
-    
-    doMoreWork = false;
+  
+  free(data->arrow);
+  free(data);
+  free(work_req);
+  
+  self->Unref();
+}
+
+/*
+ * ExportRows
+ *
+ * Writes every remaining row to a file as CSV or NDJSON. The rows are
+ * fetched, formatted and written on the thread pool a block at a time; the
+ * main thread only hears how many rows are done, through the optional
+ * progress callback after each block and the final callback.
+ */
+
+NAN_METHOD(ODBCResult::ExportRows) {
+  DEBUG_PRINTF("ODBCResult::ExportRows\n");
+  Nan::HandleScope scope;
+  
+  ODBCResult* objODBCResult = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
+  
+  if (info.Length() != 2 || !info[0]->IsObject() || !info[1]->IsFunction()) {
+    return Nan::ThrowTypeError("ODBCResult::ExportRows(): 2 arguments are required, an options object and a callback function.");
   }
-  //check to see if we are at the end of the recordset
-  else if (data->result == SQL_NO_DATA) {
-    doMoreWork = false;
+  
+  Local<Object> obj = Nan::To<v8::Object>(info[0]).ToLocalChecked();
+  Local<Function> cb = Local<Function>::Cast(info[1]);
+  
+  Local<Value> format = Nan::Get(obj, Nan::New("format").ToLocalChecked()).ToLocalChecked();
+  Local<Value> fd = Nan::Get(obj, Nan::New("fd").ToLocalChecked()).ToLocalChecked();
+  Local<Value> path = Nan::Get(obj, Nan::New("path").ToLocalChecked()).ToLocalChecked();
+  Local<Value> header = Nan::Get(obj, Nan::New("header").ToLocalChecked()).ToLocalChecked();
+  Local<Value> progress = Nan::Get(obj, Nan::New("progress").ToLocalChecked()).ToLocalChecked();
+  Local<Value> rowsetSize = Nan::Get(obj, Nan::New<String>(OPTION_ROWSET_SIZE)).ToLocalChecked();
+  int exportFormat;
+  
+  if (format->IsString() && strcmp(*Nan::Utf8String(format), "csv") == 0) {
+    exportFormat = EXPORT_CSV;
+  }
+  else if (format->IsString() && strcmp(*Nan::Utf8String(format), "ndjson") == 0) {
+    exportFormat = EXPORT_NDJSON;
   }
   else {
-    //TODO: !important: persistent forces us to set this to a local handle, but do we need to recopy it back to persistent handle?
-    Local<Array> rows = Nan::New(data->rows);
-    if (data->fetchMode == FETCH_ARRAY) {
-      Nan::Set(rows,
-        Nan::New(data->count), 
-        ODBC::GetRecordArray(
-          self->m_hSTMT,
-          self->columns,
-          &self->colCount,
-          self->buffer,
-          self->bufferLength)
-      );
-    }
-    else {
-      Nan::Set(rows,
-        Nan::New(data->count), 
-        ODBC::GetRecordTuple(
-          self->m_hSTMT,
-          self->columns,
-          &self->colCount,
-          self->buffer,
-          self->bufferLength)
-      );
-    }
-    data->count++;
+    return Nan::ThrowTypeError("ODBCResult::ExportRows(): format must be 'csv' or 'ndjson'.");
   }
   
-  if (doMoreWork) {
-    //Go back to the thread pool and fetch more data!
-    uv_queue_work(
-      uv_default_loop(),
-      work_req, 
-      UV_FetchAll, 
-      (uv_after_work_cb)UV_AfterFetchAll);
+  if (!fd->IsInt32() && !path->IsString()) {
+    return Nan::ThrowTypeError("ODBCResult::ExportRows(): an fd or a path is required.");
+  }
+  
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  MEMCHECK( work_req );
+  
+  export_work_data* data = (export_work_data *) calloc(1, sizeof(export_work_data));
+  MEMCHECK( data );
+  
+  data->format = exportFormat;
+  data->header = header->IsBoolean() ? Nan::To<bool>(header).FromJust() : true;
+  data->rowsetSize = rowsetSize->IsInt32() ? Nan::To<int32_t>(rowsetSize).FromJust() : objODBCResult->m_rowsetSize;
+  data->started = false;
+  data->count = 0;
+  
+  //a path is opened on the thread pool and closed at the end, an fd is not
+  if (fd->IsInt32()) {
+    data->fd = Nan::To<int32_t>(fd).FromJust();
+    data->path = NULL;
   }
   else {
-    ODBC::FreeColumns(self->columns, &self->colCount);
+    data->fd = -1;
+    data->path = strdup(*Nan::Utf8String(path));
+    MEMCHECK( data->path );
+  }
+  
+  data->progress = progress->IsFunction() ? new Nan::Callback(Local<Function>::Cast(progress)) : NULL;
+  data->cb = new Nan::Callback(cb);
+  data->objResult = objODBCResult;
+  
+  work_req->data = data;
+  
+  uv_queue_work(uv_default_loop(),
+    work_req, 
+    UV_ExportRows, 
+    (uv_after_work_cb)UV_AfterExportRows);
+
+  data->objResult->Ref();
+
+  info.GetReturnValue().Set(Nan::Undefined());
+}
+
+/*
+ * WriteExportBuffer
+ *
+ * Writes out and empties the formatted rows. Returns 0 or a libuv error.
+ */
+
+static int WriteExportBuffer(uv_file fd, ExportBuffer* out) {
+  size_t written = 0;
+  
+  while (written < out->length) {
+    uv_fs_t req;
+    uv_buf_t buf = uv_buf_init(out->data + written, (unsigned int) (out->length - written));
+    int ret = uv_fs_write(uv_default_loop(), &req, fd, &buf, 1, -1, NULL);
     
-    Local<Value> info[2];
+    uv_fs_req_cleanup(&req);
     
-    if (data->errorCount > 0) {
-      info[0] = Nan::New(data->objError);
-    }
-    else {
-      info[0] = Nan::Null();
+    if (ret < 0) {
+      return ret;
     }
     
-    info[1] = Nan::New(data->rows);
-
-    Nan::TryCatch try_catch;
+    written += ret;
+  }
+  
+  out->length = 0;
+  
+  return 0;
+}
 
-    data->cb->Call(2, info);
-    delete data->cb;
-    data->rows.Reset();
-    data->objError.Reset();
+/*
+ * ExportBlock
+ *
+ * Called from the thread pool to fetch and format rows until
+ * EXPORT_BLOCK_SIZE bytes are ready, then write them out. Returns
+ * SQL_NO_DATA once every row is written.
+ */
 
-    if (try_catch.HasCaught()) {
-      FatalException(try_catch);
+SQLRETURN ODBCResult::ExportBlock(export_work_data* data) {
+  SQLRETURN ret = SQL_NO_DATA;
+  
+  while (colCount > 0 && data->out.length < EXPORT_BLOCK_SIZE) {
+    ret = FetchRowset(0);
+    
+    if (!SQL_SUCCEEDED(ret)) {
+      break;
+    }
+    
+    if (rowset != NULL) {
+      for (SQLULEN row = 0; row < rowsFetched[0]; row++) {
+        if (rowStatus[row] == SQL_ROW_ERROR) {
+          return SQL_ERROR;
+        }
+        
+        if (!ODBC::AppendExportRow(columns, colCount, rowset, row, data->format, m_valueFlags, &data->out)) {
+          data->errorMessage = EXPORT_MEMORY_ERROR;
+          return SQL_ERROR;
+        }
+        
+        data->count++;
+      }
+    }
+    else {
+      ret = FetchRowData(colCount);
+      
+      if (!SQL_SUCCEEDED(ret)) {
+        return ret;
+      }
+      
+      if (!ODBC::AppendExportRow(columns, colCount, rowBuffer, 0, data->format, m_valueFlags, &data->out)) {
+        data->errorMessage = EXPORT_MEMORY_ERROR;
+        return SQL_ERROR;
+      }
+      
+      data->count++;
     }
+  }
+  
+  if (ret == SQL_ERROR) {
+    return ret;
+  }
+  
+  int written = WriteExportBuffer(data->fd, &data->out);
+  
+  if (written < 0) {
+    data->errorMessage = uv_strerror(written);
+    return SQL_ERROR;
+  }
+  
+  return ret;
+}
 
-    //TODO: Do we need to free self->rows somehow?
-    free(data);
-    free(work_req);
+void ODBCResult::UV_ExportRows(uv_work_t* work_req) {
+  DEBUG_PRINTF("ODBCResult::UV_ExportRows\n");
+  
+  export_work_data* data = (export_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  //the first pass opens the file, binds the rowset and writes the header
+  if (!data->started) {
+    data->started = true;
+    
+    if (data->path != NULL) {
+      uv_fs_t req;
+      int fd = uv_fs_open(uv_default_loop(), &req, data->path, O_WRONLY | O_CREAT | O_TRUNC, 0666, NULL);
+      
+      uv_fs_req_cleanup(&req);
+      
+      if (fd < 0) {
+        data->errorMessage = uv_strerror(fd);
+        data->result = SQL_ERROR;
+        return;
+      }
+      
+      data->fd = fd;
+    }
+    
+    if (self->colCount == 0) {
+      self->LoadColumns();
+    }
+    
+    if (data->rowsetSize > 1) {
+      self->BindRowset(data->rowsetSize);
+    }
+    
+    if (data->format == EXPORT_CSV && data->header && self->colCount > 0 &&
+        !ODBC::AppendExportHeader(self->columns, self->colCount, &data->out)) {
+      data->errorMessage = EXPORT_MEMORY_ERROR;
+      data->result = SQL_ERROR;
+      return;
+    }
+  }
+  
+  data->result = self->ExportBlock(data);
+}
 
-    self->Unref(); 
+void ODBCResult::UV_AfterExportRows(uv_work_t* work_req, int status) {
+  DEBUG_PRINTF("ODBCResult::UV_AfterExportRows\n");
+  Nan::HandleScope scope;
+  
+  export_work_data* data = (export_work_data *)(work_req->data);
+  
+  ODBCResult* self = data->objResult->self();
+  
+  Local<Value> info[2];
+  
+  info[1] = Nan::New<Number>((double) data->count);
+  
+  //a full block was written, report it and go back for the next one
+  if (SQL_SUCCEEDED(data->result)) {
+    if (data->progress != NULL) {
+      Nan::TryCatch try_catch;
+      
+      data->progress->Call(1, &info[1]);
+      
+      if (try_catch.HasCaught()) {
+        FatalException(try_catch);
+      }
+    }
+    
+    //the progress callback may have closed the result, which frees the
+    //columns and the statement the next block would use
+    if (self->colCount == 0 || self->m_hSTMT == NULL) {
+      data->result = SQL_ERROR;
+      data->errorMessage = "[node-informixdb] The result was closed during exportRows.";
+    }
+    else {
+      uv_queue_work(
+        uv_default_loop(),
+        work_req, 
+        UV_ExportRows, 
+        (uv_after_work_cb)UV_AfterExportRows);
+      
+      return;
+    }
+  }
+  
+  if (data->result == SQL_NO_DATA) {
+    info[0] = Nan::Null();
+  }
+  else if (data->errorMessage != NULL) {
+    info[0] = Nan::Error(data->errorMessage);
+  }
+  else {
+    info[0] = ODBC::GetSQLError(
+      SQL_HANDLE_STMT, 
+      self->m_hSTMT,
+      (char *) "[node-informixdb] Error in ODBCResult::UV_AfterExportRows"
+    );
+  }
+  
+  if (data->path != NULL && data->fd >= 0) {
+    uv_fs_t req;
+    
+    if (uv_fs_close(uv_default_loop(), &req, data->fd, NULL) < 0 && data->result == SQL_NO_DATA) {
+      info[0] = Nan::Error(uv_strerror((int) req.result));
+    }
+    
+    uv_fs_req_cleanup(&req);
+  }
+  
+  self->ReleaseColumns();
+  
+  ODBC::FreeExportBuffer(&data->out);
+  free(data->path);
+  
+  Nan::TryCatch try_catch;
+  
+  data->cb->Call(2, info);
+  delete data->cb;
+  delete data->progress;
+  
+  if (try_catch.HasCaught()) {
+    FatalException(try_catch);
   }
+  
+  free(data);
+  free(work_req);
+  
+  self->Unref();
 }
 
 /*
@@ -599,13 +2264,43 @@ NAN_METHOD(ODBCResult::FetchAllSync) {
   }
   
   if (self->colCount == 0) {
-    self->columns = ODBC::GetColumns(self->m_hSTMT, &self->colCount);
+    self->LoadColumns();
   }
   
   Local<Array> rows = Nan::New<Array>();
   
+  //in columnar mode the whole result set is read at once
+  if (self->colCount > 0 && fetchMode == FETCH_COLUMNAR) {
+    const char *errorMessage = NULL;
+    
+    ret = self->FetchColumnar(&errorMessage);
+    
+    if (ret == SQL_NO_DATA) {
+      rows = ODBC::GetColumnVectorsArray(self->columns, self->vectors, self->colCount);
+    }
+    else if (errorMessage != NULL) {
+      errorCount++;
+      objError = Nan::Error(errorMessage);
+    }
+    else {
+      errorCount++;
+      
+      objError = ODBC::GetSQLError(
+        SQL_HANDLE_STMT, 
+        self->m_hSTMT,
+        (char *) "[node-informixdb] Error in ODBCResult::FetchAllSync"
+      );
+    }
+    
+    self->ReleaseColumns();
+  }
   //Only loop through the recordset if there are columns
-  if (self->colCount > 0) {
+  else if (self->colCount > 0) {
+    self->lobIndex = 0;
+    
+    //back to one row at a time after fetchMany()
+    self->UnbindRowset();
+    
     //loop through all records
     while (true) {
       ret = SQLFetch(self->m_hSTMT);
@@ -626,7 +2321,7 @@ NAN_METHOD(ODBCResult::FetchAllSync) {
       
       //check to see if we are at the end of the recordset
       if (ret == SQL_NO_DATA) {
-        ODBC::FreeColumns(self->columns, &self->colCount);
+        self->ReleaseColumns();
         
         break;
       }
@@ -638,8 +2333,9 @@ NAN_METHOD(ODBCResult::FetchAllSync) {
             self->m_hSTMT,
             self->columns,
             &self->colCount,
-            self->buffer,
-            self->bufferLength)
+            &self->scratch,
+            self->m_valueFlags,
+            self->dictionary)
         );
       }
       else {
@@ -649,15 +2345,18 @@ NAN_METHOD(ODBCResult::FetchAllSync) {
             self->m_hSTMT,
             self->columns,
             &self->colCount,
-            self->buffer,
-            self->bufferLength)
+            &self->scratch,
+            self->ColumnNames(),
+            self->RowTemplate(),
+            self->m_valueFlags,
+            self->dictionary)
         );
       }
       count++;
     }
   }
   else {
-    ODBC::FreeColumns(self->columns, &self->colCount);
+    self->ReleaseColumns();
   }
   
   //throw the error object if there were errors
@@ -691,6 +2390,8 @@ NAN_METHOD(ODBCResult::CloseSync) {
     //We technically can't free the handle so, we'll SQL_CLOSE
     uv_mutex_lock(&ODBC::g_odbcMutex);
     
+    result->ReleaseColumns();
+    
     SQLFreeStmt(result->m_hSTMT, SQL_CLOSE);
   
     uv_mutex_unlock(&ODBC::g_odbcMutex);
@@ -712,6 +2413,9 @@ NAN_METHOD(ODBCResult::MoreResultsSync) {
   
   ODBCResult* result = Nan::ObjectWrap::Unwrap<ODBCResult>(info.Holder());
   
+  //the column metadata and keys belong to the result set being left
+  result->ReleaseColumns();
+  
   SQLRETURN ret = SQLMoreResults(result->m_hSTMT);
 
   if (ret == SQL_ERROR) {
@@ -734,7 +2438,7 @@ NAN_METHOD(ODBCResult::GetColumnNamesSync) {
   Local<Array> cols = Nan::New<Array>();
   
   if (self->colCount == 0) {
-    self->columns = ODBC::GetColumns(self->m_hSTMT, &self->colCount);
+    self->LoadColumns();
   }
   
   for (int i = 0; i < self->colCount; i++) {
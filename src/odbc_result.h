@@ -25,6 +25,9 @@
 class ODBCResult : public Nan::ObjectWrap {
   public:
    static Nan::Persistent<String> OPTION_FETCH_MODE;
+   static Nan::Persistent<String> OPTION_ROWSET_SIZE;
+   static Nan::Persistent<String> OPTION_LOB_STREAM;
+   static Nan::Persistent<String> OPTION_PREFETCH;
    static Nan::Persistent<Function> constructor;
    static void Init(v8::Local<Object> exports);
    
@@ -50,10 +53,30 @@ class ODBCResult : public Nan::ObjectWrap {
     static void UV_Fetch(uv_work_t* work_req);
     static void UV_AfterFetch(uv_work_t* work_req, int status);
 
+    static NAN_METHOD(FetchMany);
+    static NAN_METHOD(FetchAbsolute);
+    static NAN_METHOD(FetchRelative);
+    static void FetchScroll(const Nan::FunctionCallbackInfo<v8::Value>& info, SQLSMALLINT orientation,
+                            const char* method);
+    static void UV_FetchMany(uv_work_t* work_req);
+    static void UV_AfterFetchMany(uv_work_t* work_req, int status);
+
     static NAN_METHOD(FetchAll);
     static void UV_FetchAll(uv_work_t* work_req);
     static void UV_AfterFetchAll(uv_work_t* work_req, int status);
     
+    static NAN_METHOD(FetchArrow);
+    static void UV_FetchArrow(uv_work_t* work_req);
+    static void UV_AfterFetchArrow(uv_work_t* work_req, int status);
+    
+    static NAN_METHOD(ExportRows);
+    static void UV_ExportRows(uv_work_t* work_req);
+    static void UV_AfterExportRows(uv_work_t* work_req, int status);
+    
+    static NAN_METHOD(ReadLob);
+    static void UV_ReadLob(uv_work_t* work_req);
+    static void UV_AfterReadLob(uv_work_t* work_req, int status);
+    
     //sync methods
     static NAN_METHOD(CloseSync);
     static NAN_METHOD(MoreResultsSync);
@@ -64,6 +87,40 @@ class ODBCResult : public Nan::ObjectWrap {
     //property getter/setters
     static NAN_GETTER(FetchModeGetter);
     static NAN_SETTER(FetchModeSetter);
+    static NAN_GETTER(RowsetSizeGetter);
+    static NAN_SETTER(RowsetSizeSetter);
+    static NAN_GETTER(PrefetchGetter);
+    static NAN_SETTER(PrefetchSetter);
+    static NAN_GETTER(MaxBufferSizeGetter);
+    static NAN_SETTER(MaxBufferSizeSetter);
+    static NAN_GETTER(TimestampAsNumberGetter);
+    static NAN_SETTER(TimestampAsNumberSetter);
+    static NAN_GETTER(TrimCharGetter);
+    static NAN_SETTER(TrimCharSetter);
+    static NAN_GETTER(BigIntModeGetter);
+    static NAN_SETTER(BigIntModeSetter);
+    static NAN_GETTER(DecimalModeGetter);
+    static NAN_SETTER(DecimalModeSetter);
+    static NAN_GETTER(DedupeStringsGetter);
+    static NAN_SETTER(DedupeStringsSetter);
+    
+    bool BindRowset(SQLULEN size, int sets = 1);
+    void UnbindRowset();
+    SQLRETURN FetchRowset(int set, SQLSMALLINT orientation = SQL_FETCH_NEXT, SQLLEN offset = 0);
+    bool RowsetError(int set);
+    bool RowsetComplete(int set);
+    SQLRETURN FetchRowData(short count);
+    SQLRETURN ReadLobChunk();
+    Local<Value> LobChunkValue();
+    SQLRETURN FetchColumnar(const char** errorMessage);
+    Nan::Persistent<String>* ColumnNames();
+    Local<ObjectTemplate> RowTemplate();
+    Local<ObjectTemplate> LazyRowTemplate();
+    void LoadColumns();
+    void ReleaseColumns();
+    
+    struct fetch_work_data;
+    bool PushFetchedRows(fetch_work_data* data, int set);
     
     struct fetch_work_data {
       Nan::Callback* cb;
@@ -71,12 +128,40 @@ class ODBCResult : public Nan::ObjectWrap {
       SQLRETURN result;
       
       int fetchMode;
+      int rowsetSize;
+      int limit;
+      SQLSMALLINT orientation;
+      SQLLEN offset;
+      bool lobStream;
+      bool prefetch;
       int count;
       int errorCount;
+      const char *errorMessage;
+      char *arrow;
+      size_t arrowLength;
       Nan::Persistent<Array> rows;
       Nan::Persistent<Value> objError;
     };
     
+    struct export_work_data {
+      Nan::Callback* cb;
+      Nan::Callback* progress;
+      ODBCResult *objResult;
+      SQLRETURN result;
+      
+      int format;
+      bool header;
+      int rowsetSize;
+      bool started;
+      uv_file fd;
+      char *path;
+      int64_t count;
+      const char *errorMessage;
+      ExportBuffer out;
+    };
+    
+    SQLRETURN ExportBlock(export_work_data* data);
+    
     ODBCResult *self(void) { return this; }
 
   protected:
@@ -85,11 +170,57 @@ class ODBCResult : public Nan::ObjectWrap {
     SQLHSTMT m_hSTMT;
     bool m_canFreeHandle;
     int m_fetchMode;
+    int m_rowsetSize;
+    bool m_prefetch;
+    int m_valueFlags;
     
-    uint16_t *buffer;
-    int bufferLength;
+    //values read by the sync methods, kept across rows up to maxBufferSize
+    ScratchBuffer scratch;
     Column *columns;
     short colCount;
+    
+    //metadata shared with the prepared statement, NULL when columns is ours
+    ColumnCache *columnCache;
+
+    //object keys shared by the rows of the current result set
+    Nan::Persistent<String> *columnNames;
+
+    //creates the rows of the current result set with all their properties,
+    //shared with the other results with the same column names
+    Nan::Persistent<ObjectTemplate> rowTemplate;
+    bool rowTemplateLoaded;
+
+    //creates the FETCH_LAZY rows of the current result set
+    Nan::Persistent<ObjectTemplate> lazyTemplate;
+    bool lazyTemplateLoaded;
+
+    //values of the current row, read on the thread pool
+    ColumnBuffer *rowBuffer;
+
+    //strings shared by repeated character values, NULL unless dedupeStrings
+    StringDictionary *dictionary;
+
+    //values of the whole result set while fetching in FETCH_COLUMNAR mode
+    ColumnVector *vectors;
+
+    //column of the current row being streamed in chunks, 0 when none
+    SQLUSMALLINT lobIndex;
+    SQLSMALLINT lobCType;
+    char *lobBuffer;
+    SQLLEN lobLength;
+
+    //bound column arrays while fetching in rowset mode, NULL otherwise;
+    //with prefetch there are two sets, one filled on the thread pool while
+    //the rows of the other are converted
+    ColumnBuffer *rowset;
+    SQLULEN rowsetSize;
+    SQLULEN rowsetRequest;
+    int rowsetSets;
+    SQLLEN rowsetOffset;
+    int rowsetNext;
+    int rowsetFilled;
+    SQLULEN rowsFetched[2];
+    SQLUSMALLINT *rowStatus;
 };
 
 
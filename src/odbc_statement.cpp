@@ -64,7 +64,13 @@ void ODBCStatement::Init(v8::Local<Object> exports) {
   Nan::SetPrototypeMethod(t, "bind", Bind);
   Nan::SetPrototypeMethod(t, "bindSync", BindSync);
   
+  Nan::SetPrototypeMethod(t, "executeBatch", ExecuteBatch);
+  Nan::SetPrototypeMethod(t, "executeBatchSync", ExecuteBatchSync);
+  
   Nan::SetPrototypeMethod(t, "closeSync", CloseSync);
+  
+  // Properties
+  Nan::SetAccessor(instance_template, Nan::New("cursorType").ToLocalChecked(), CursorTypeGetter, CursorTypeSetter);
 
   // Attach the Database Constructor to the target object
   constructor.Reset(Nan::GetFunction(t).ToLocalChecked());
@@ -78,11 +84,10 @@ ODBCStatement::~ODBCStatement() {
 
 void ODBCStatement::Free() {
   DEBUG_PRINTF("ODBCStatement::Free paramCount = %i, m_hSTMT =%X\n", paramCount, m_hSTMT);
-  //if we previously had parameters, then be sure to free them
-  if (paramCount) {
-      FREE_PARAMS( params, paramCount ) ;
-      DEBUG_PRINTF("ODBCStatement::Free - Params Freed.\n");
-  }
+  //free the parameters along with the memory kept for them
+  FREE_PARAMS( params, paramCount, paramArena ) ;
+  ODBC::FreeParamArena(&rebindArena);
+  DEBUG_PRINTF("ODBCStatement::Free - Params Freed.\n");
   
   if (m_hSTMT) {
     uv_mutex_lock(&ODBC::g_odbcMutex);
@@ -97,9 +102,50 @@ void ODBCStatement::Free() {
       buffer = NULL;
       bufferLength = 0;
   }
+  
+  InvalidateColumns();
   DEBUG_PRINTF("ODBCStatement::Free() Done.\n");
 }
 
+/*
+ * NewResult
+ *
+ * Wraps the current result set of the statement in an ODBCResult that
+ * shares the cached column metadata.
+ */
+
+Local<Object> ODBCStatement::NewResult() {
+  Nan::EscapableHandleScope scope;
+  
+  Local<Value> info[5];
+  bool* canFreeHandle = new bool(false);
+  int argc = 4;
+  
+  info[0] = Nan::New<External>((void*) (intptr_t) m_hENV);
+  info[1] = Nan::New<External>((void*) (intptr_t) m_hDBC);
+  info[2] = Nan::New<External>((void*) (intptr_t) m_hSTMT);
+  info[3] = Nan::New<External>((void*)canFreeHandle);
+  
+  if (columnCache != NULL) {
+    info[4] = Nan::New<External>((void*)columnCache);
+    argc = 5;
+  }
+  
+  return scope.Escape(Nan::NewInstance(Nan::New(ODBCResult::constructor), argc, info).ToLocalChecked());
+}
+
+/*
+ * InvalidateColumns
+ *
+ * Forgets the cached column metadata before the statement gets new SQL.
+ * Results still reading their rows keep their own reference.
+ */
+
+void ODBCStatement::InvalidateColumns() {
+  ODBC::ReleaseColumnCache(columnCache);
+  columnCache = NULL;
+}
+
 NAN_METHOD(ODBCStatement::New) {
   DEBUG_PRINTF("ODBCStatement::New\n");
   Nan::HandleScope scope;
@@ -122,12 +168,18 @@ NAN_METHOD(ODBCStatement::New) {
   stmt->buffer = (uint16_t *) malloc(stmt->bufferLength+2);
   MEMCHECK( stmt->buffer );
 
-  //set the initial colCount to 0
-  stmt->colCount = 0;
+  //no columns are known until the first execution
+  stmt->columnCache = NULL;
+  
+  stmt->m_cursorType = SQL_CURSOR_FORWARD_ONLY;
   
   //initialize the paramCount
   stmt->paramCount = 0;
   stmt->params = 0;
+  stmt->paramArena.blocks = NULL;
+  stmt->paramArena.allocated = 0;
+  stmt->rebindArena.blocks = NULL;
+  stmt->rebindArena.allocated = 0;
   
   stmt->Wrap(info.Holder());
   
@@ -178,6 +230,11 @@ void ODBCStatement::UV_Execute(uv_work_t* req) {
   SQLRETURN ret;
   
   ret = SQLExecute(data->stmt->m_hSTMT); 
+  
+  //the columns only change when the statement is prepared again
+  if (SQL_SUCCEEDED(ret) && data->stmt->columnCache == NULL) {
+    data->stmt->columnCache = ODBC::GetColumnCache(data->stmt->m_hSTMT);
+  }
 
   data->result = ret;
 }
@@ -201,9 +258,7 @@ void ODBCStatement::UV_AfterExecute(uv_work_t* req, int status) {
       }
     }
   }
-  if( stmt->paramCount ) {
-    FREE_PARAMS( stmt->params, stmt->paramCount ) ;
-  }
+  //the parameters stay bound, for the next bind to update in place
   
   //First thing, let's check if the execution of the query returned any errors 
   if(data->result == SQL_ERROR) {
@@ -213,15 +268,8 @@ void ODBCStatement::UV_AfterExecute(uv_work_t* req, int status) {
       data->cb);
   }
   else {
-    Local<Value> info[4];
-    bool* canFreeHandle = new bool(false);
-    
-    info[0] = Nan::New<External>((void*) (intptr_t) stmt->m_hENV);
-    info[1] = Nan::New<External>((void*) (intptr_t) stmt->m_hDBC);
-    info[2] = Nan::New<External>((void*) (intptr_t) stmt->m_hSTMT);
-    info[3] = Nan::New<External>((void*)canFreeHandle);
-    
-    Local<Object> js_result = Nan::NewInstance(Nan::New(ODBCResult::constructor), 4, info).ToLocalChecked();
+    Local<Value> info[3];
+    Local<Object> js_result = stmt->NewResult();
 
     info[0] = Nan::Null();
     info[1] = js_result;
@@ -264,6 +312,10 @@ NAN_METHOD(ODBCStatement::ExecuteSync) {
   SQLRETURN ret = SQLExecute(stmt->m_hSTMT); 
 
   if (SQL_SUCCEEDED(ret)) {
+    if (stmt->columnCache == NULL) {
+      stmt->columnCache = ODBC::GetColumnCache(stmt->m_hSTMT);
+    }
+    
     for(int i = 0; i < stmt->paramCount; i++) { // For stored Procedure CALL
       if(stmt->params[i].paramtype % 2 == 0) {
         Nan::Set(sp_result, Nan::New(outParamCount), ODBC::GetOutputParameter(stmt->params[i]));
@@ -271,9 +323,7 @@ NAN_METHOD(ODBCStatement::ExecuteSync) {
       }
     }
   }
-  if( stmt->paramCount ) {
-    FREE_PARAMS( stmt->params, stmt->paramCount ) ;
-  }
+  //the parameters stay bound, for the next bind to update in place
   
   if(ret == SQL_ERROR) {
     Nan::ThrowError(ODBC::GetSQLError(
@@ -285,15 +335,7 @@ NAN_METHOD(ODBCStatement::ExecuteSync) {
     info.GetReturnValue().Set(Nan::Null());
   }
   else {
-    Local<Value> result[4];
-    bool* canFreeHandle = new bool(false);
-    
-    result[0] = Nan::New<External>((void*) (intptr_t) stmt->m_hENV);
-    result[1] = Nan::New<External>((void*) (intptr_t) stmt->m_hDBC);
-    result[2] = Nan::New<External>((void*) (intptr_t) stmt->m_hSTMT);
-    result[3] = Nan::New<External>((void*)canFreeHandle);
-    
-    Local<Object> js_result = Nan::NewInstance(Nan::New(ODBCResult::constructor), 4, result).ToLocalChecked();
+    Local<Object> js_result = stmt->NewResult();
 
     if( outParamCount ) // Its a CALL stmt with OUT params.
     {   // Return an array with outparams as second element. [result, outparams]
@@ -485,6 +527,8 @@ NAN_METHOD(ODBCStatement::ExecuteDirect) {
   data->stmt = stmt;
   work_req->data = data;
   
+  stmt->InvalidateColumns();
+  
   uv_queue_work(
     uv_default_loop(),
     work_req, 
@@ -579,6 +623,8 @@ NAN_METHOD(ODBCStatement::ExecuteDirectSync) {
 
   ODBCStatement* stmt = Nan::ObjectWrap::Unwrap<ODBCStatement>(info.Holder());
   
+  stmt->InvalidateColumns();
+  
   SQLRETURN ret = SQLExecDirect(
     stmt->m_hSTMT,
     (SQLTCHAR *) *sql, 
@@ -627,6 +673,8 @@ NAN_METHOD(ODBCStatement::PrepareSync) {
 
   SQLRETURN ret;
 
+  stmt->InvalidateColumns();
+
   int sqlLen = sql->Length() + 1;
 
 #ifdef UNICODE
@@ -700,6 +748,8 @@ NAN_METHOD(ODBCStatement::Prepare) {
   
   work_req->data = data;
   
+  stmt->InvalidateColumns();
+  
   uv_queue_work(
     uv_default_loop(), 
     work_req, 
@@ -796,19 +846,11 @@ NAN_METHOD(ODBCStatement::BindSync)
     stmt->m_hSTMT
   );
   
-  //if we previously had parameters, then be sure to free them
-  //before allocating more
-  if (stmt->paramCount) {
-      FREE_PARAMS( stmt->params, stmt->paramCount ) ;
-  }
-  
-  stmt->params = ODBC::GetParametersFromArray(
-    Local<Array>::Cast(info[0]), 
-    &stmt->paramCount);
+  char *changed = stmt->SetParameters(Local<Array>::Cast(info[0]));
   
   SQLRETURN ret = SQL_SUCCESS;
 
-  ret = ODBC::BindParameters( stmt->m_hSTMT, stmt->params, stmt->paramCount ) ;
+  ret = ODBC::BindParameters( stmt->m_hSTMT, stmt->params, stmt->paramCount, changed ) ;
 
   if (SQL_SUCCEEDED(ret)) {
     info.GetReturnValue().Set(Nan::True());
@@ -851,12 +893,6 @@ NAN_METHOD(ODBCStatement::Bind) {
     (bind_work_data *) calloc(1, sizeof(bind_work_data));
   MEMCHECK( data );
 
-  //if we previously had parameters, then be sure to free them
-  //before allocating more
-  if (stmt->paramCount) {
-      FREE_PARAMS( stmt->params, stmt->paramCount ) ;
-  }
-  
   data->stmt = stmt;
   
   DEBUG_PRINTF("ODBCStatement::Bind m_hDBC=%X m_hDBC=%X m_hSTMT=%X\n",
@@ -867,9 +903,7 @@ NAN_METHOD(ODBCStatement::Bind) {
   
   data->cb = new Nan::Callback(cb);
   
-  data->stmt->params = ODBC::GetParametersFromArray(
-    Local<Array>::Cast(info[0]), 
-    &data->stmt->paramCount);
+  data->changed = stmt->SetParameters(Local<Array>::Cast(info[0]));
   
   work_req->data = data;
   
@@ -896,7 +930,7 @@ void ODBCStatement::UV_Bind(uv_work_t* req) {
   );
   
   data->result = ODBC::BindParameters( data->stmt->m_hSTMT, 
-                 data->stmt->params, data->stmt->paramCount ) ;
+                 data->stmt->params, data->stmt->paramCount, data->changed ) ;
 }
 
 void ODBCStatement::UV_AfterBind(uv_work_t* req, int status) {
@@ -938,6 +972,321 @@ void ODBCStatement::UV_AfterBind(uv_work_t* req, int status) {
   free(req);
 }
 
+/*
+ * GetBatchArrays
+ *
+ * The ParameterArrays of the first argument of ExecuteBatch: an Array of
+ * rows, or an object with the columns of the batch. Typed arrays are bound
+ * in place when inPlace is true, which only a synchronous execution can do.
+ */
+
+static ParameterArray* GetBatchArrays(Local<Value> batch, int* paramCount, SQLULEN* rowCount,
+                                      bool inPlace) {
+  if (batch->IsArray()) {
+    return ODBC::GetParameterArrays(Local<Array>::Cast(batch), paramCount, rowCount);
+  }
+  
+  if (batch->IsObject()) {
+    Local<Value> columns = Nan::Get(Nan::To<Object>(batch).ToLocalChecked(),
+                                    Nan::New("columns").ToLocalChecked()).ToLocalChecked();
+    
+    if (columns->IsArray()) {
+      return ODBC::GetColumnParameterArrays(Local<Array>::Cast(columns), paramCount, rowCount, inPlace);
+    }
+  }
+  
+  Nan::ThrowTypeError("Argument 0 must be an Array of rows or an object with an Array of columns");
+  return NULL;
+}
+
+/*
+ * ExecuteBatch
+ *
+ * Execute the prepared statement once for every row of an Array of rows,
+ * with the values of each parameter bound as one array and
+ * SQL_ATTR_PARAMSET_SIZE set to the number of rows, so that the whole batch
+ * takes one SQLExecute. The values can also be given as { columns }, see
+ * ODBC::GetColumnParameterArrays. The callback gets an object with the
+ * number of rows affected, the number of rows processed and the indexes of
+ * the rows that failed; when any did, it gets the error as well.
+ */
+
+NAN_METHOD(ODBCStatement::ExecuteBatch) {
+  DEBUG_PRINTF("ODBCStatement::ExecuteBatch\n");
+  
+  Nan::HandleScope scope;
+
+  REQ_FUN_ARG(1, cb);
+
+  ODBCStatement* stmt = Nan::ObjectWrap::Unwrap<ODBCStatement>(info.Holder());
+  
+  int paramCount;
+  SQLULEN rowCount;
+  //JavaScript runs during the execution and could change or detach the
+  //typed arrays, so their values are copied
+  ParameterArray *arrays = GetBatchArrays(info[0], &paramCount, &rowCount, false);
+  
+  if (!arrays) {
+    return;
+  }
+  
+  uv_work_t* work_req = (uv_work_t *) (calloc(1, sizeof(uv_work_t)));
+  MEMCHECK( work_req );
+  
+  execute_batch_work_data* data = 
+    (execute_batch_work_data *) calloc(1, sizeof(execute_batch_work_data));
+  MEMCHECK( data );
+  
+  data->status = (SQLUSMALLINT *) calloc(rowCount, sizeof(SQLUSMALLINT));
+  MEMCHECK( data->status );
+
+  data->cb = new Nan::Callback(cb);
+  data->stmt = stmt;
+  data->arrays = arrays;
+  data->paramCount = paramCount;
+  data->rowCount = rowCount;
+  
+  work_req->data = data;
+  
+  uv_queue_work(
+    uv_default_loop(),
+    work_req,
+    UV_ExecuteBatch,
+    (uv_after_work_cb)UV_AfterExecuteBatch);
+
+  stmt->Ref();
+  
+  info.GetReturnValue().Set(Nan::Undefined());
+}
+
+void ODBCStatement::UV_ExecuteBatch(uv_work_t* req) {
+  DEBUG_PRINTF("ODBCStatement::UV_ExecuteBatch\n");
+  
+  execute_batch_work_data* data = (execute_batch_work_data *)(req->data);
+
+  SQLRETURN ret = ODBC::BindParameterArrays(
+    data->stmt->m_hSTMT,
+    data->arrays,
+    data->paramCount,
+    data->rowCount,
+    data->status,
+    &data->processed);
+  
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLExecute(data->stmt->m_hSTMT);
+  }
+
+  data->result = ret;
+}
+
+void ODBCStatement::UV_AfterExecuteBatch(uv_work_t* req, int status) {
+  DEBUG_PRINTF("ODBCStatement::UV_AfterExecuteBatch\n");
+  
+  execute_batch_work_data* data = (execute_batch_work_data *)(req->data);
+  
+  Nan::HandleScope scope;
+  
+  //an easy reference to the statment object
+  ODBCStatement* self = data->stmt->self();
+
+  Local<Value> info[2];
+
+  info[0] = Nan::Null();
+
+  //read the diagnostics first: any other call on the handle, SQLRowCount
+  //included, clears them. Some rows can fail while the others succeed, and
+  //then SQLExecute returns SQL_SUCCESS_WITH_INFO
+  if (data->result == SQL_ERROR ||
+      BatchFailed(data->rowCount, data->status, data->processed)) {
+    info[0] = ODBC::GetSQLError(
+      SQL_HANDLE_STMT,
+      self->m_hSTMT,
+      (char *) "[node-informixdb] Error in ODBCStatement::ExecuteBatch");
+  }
+
+  info[1] = self->GetBatchResult(data->rowCount, data->status, data->processed);
+
+  self->EndBatch();
+
+  Nan::TryCatch try_catch;
+  
+  data->cb->Call(Nan::GetCurrentContext()->Global(), 2, info);
+
+  if (try_catch.HasCaught()) {
+    FatalException(try_catch);
+  }
+
+  self->Unref();
+  delete data->cb;
+  
+  free(data->arrays);
+  free(data->status);
+  free(data);
+  free(req);
+}
+
+/*
+ * ExecuteBatchSync
+ *
+ * Returns the same object as the callback of ExecuteBatch, and throws the
+ * error when any row failed.
+ */
+
+NAN_METHOD(ODBCStatement::ExecuteBatchSync) {
+  DEBUG_PRINTF("ODBCStatement::ExecuteBatchSync\n");
+  
+  Nan::HandleScope scope;
+
+  ODBCStatement* stmt = Nan::ObjectWrap::Unwrap<ODBCStatement>(info.Holder());
+  
+  int paramCount;
+  SQLULEN rowCount;
+  SQLULEN processed = 0;
+  ParameterArray *arrays = GetBatchArrays(info[0], &paramCount, &rowCount, true);
+  
+  if (!arrays) {
+    return;
+  }
+  
+  SQLUSMALLINT *status = (SQLUSMALLINT *) calloc(rowCount, sizeof(SQLUSMALLINT));
+  if (!status) {
+    free(arrays);
+  }
+  MEMCHECK( status );
+
+  SQLRETURN ret = ODBC::BindParameterArrays(
+    stmt->m_hSTMT,
+    arrays,
+    paramCount,
+    rowCount,
+    status,
+    &processed);
+  
+  if (SQL_SUCCEEDED(ret)) {
+    ret = SQLExecute(stmt->m_hSTMT);
+  }
+  
+  if (ret == SQL_ERROR || BatchFailed(rowCount, status, processed)) {
+    //read the diagnostics before SQLRowCount clears them
+    Local<Value> err = ODBC::GetSQLError(
+      SQL_HANDLE_STMT,
+      stmt->m_hSTMT,
+      (char *) "[node-informixdb] Error in ODBCStatement::ExecuteBatchSync");
+    Local<Object> result = stmt->GetBatchResult(rowCount, status, processed);
+    
+    Nan::Set(Nan::To<Object>(err).ToLocalChecked(), Nan::New("result").ToLocalChecked(), result);
+    
+    stmt->EndBatch();
+    free(arrays);
+    free(status);
+    
+    Nan::ThrowError(err);
+    return;
+  }
+  
+  Local<Object> result = stmt->GetBatchResult(rowCount, status, processed);
+  
+  stmt->EndBatch();
+  free(arrays);
+  free(status);
+  
+  info.GetReturnValue().Set(result);
+}
+
+/*
+ * SetParameters
+ *
+ * Take the values of a bind, copied into the parameters bound for the last
+ * execution when ODBC::UpdateParameters can, or else converted to new
+ * parameters. Returns the flags of the parameters that need SQLBindParameter
+ * again, or NULL for all of them.
+ */
+
+char* ODBCStatement::SetParameters(Local<Array> values) {
+  char *changed = ODBC::UpdateParameters(values, params, paramCount, &paramArena, &rebindArena);
+  
+  if (changed) {
+    return changed;
+  }
+  
+  //if we previously had parameters, then be sure to free them
+  //before allocating more
+  RESET_PARAMS( params, paramCount, paramArena ) ;
+  
+  params = ODBC::GetParametersFromArray(values, &paramCount, &paramArena);
+  
+  return NULL;
+}
+
+/*
+ * BatchFailed
+ *
+ * True when a row of a batch of rowCount rows has SQL_PARAM_ERROR.
+ */
+
+bool ODBCStatement::BatchFailed(SQLULEN rowCount, SQLUSMALLINT* status, SQLULEN processed) {
+  for (SQLULEN i = 0; i < processed && i < rowCount; i++) {
+    if (status[i] == SQL_PARAM_ERROR) {
+      return true;
+    }
+  }
+  
+  return false;
+}
+
+/*
+ * GetBatchResult
+ *
+ * { count, processed, failed } for a batch of rowCount rows: the number of
+ * rows affected, the number of rows SQLExecute went through and the indexes
+ * of the rows with SQL_PARAM_ERROR.
+ */
+
+Local<Object> ODBCStatement::GetBatchResult(SQLULEN rowCount, SQLUSMALLINT* status, SQLULEN processed) {
+  Nan::EscapableHandleScope scope;
+  
+  SQLLEN count = 0;
+  
+  if (!SQL_SUCCEEDED(SQLRowCount(m_hSTMT, &count))) {
+    count = 0;
+  }
+  
+  Local<Object> result = Nan::New<Object>();
+  Local<Array> failed = Nan::New<Array>();
+  uint32_t failedCount = 0;
+  
+  for (SQLULEN i = 0; i < processed && i < rowCount; i++) {
+    if (status[i] == SQL_PARAM_ERROR) {
+      Nan::Set(failed, failedCount++, Nan::New<Number>(i));
+    }
+  }
+  
+  Nan::Set(result, Nan::New("count").ToLocalChecked(), Nan::New<Number>(count));
+  Nan::Set(result, Nan::New("processed").ToLocalChecked(), Nan::New<Number>(processed));
+  Nan::Set(result, Nan::New("failed").ToLocalChecked(), failed);
+  
+  return scope.Escape(result);
+}
+
+/*
+ * EndBatch
+ *
+ * Unbind the parameter arrays of a batch, bind again the parameters of the
+ * last bind, if any, and close the cursor.
+ */
+
+void ODBCStatement::EndBatch() {
+  ODBC::ResetParameterArrays(m_hSTMT);
+  
+  if (paramCount) {
+    ODBC::BindParameters(m_hSTMT, params, paramCount);
+  }
+  
+  uv_mutex_lock(&ODBC::g_odbcMutex);
+  SQLFreeStmt(m_hSTMT, SQL_CLOSE);
+  uv_mutex_unlock(&ODBC::g_odbcMutex);
+}
+
 /*
  * CloseSync
  */
@@ -965,3 +1314,44 @@ NAN_METHOD(ODBCStatement::CloseSync) {
 
   info.GetReturnValue().Set(Nan::True());
 }
+
+/*
+ * CursorType
+ *
+ * SQL_ATTR_CURSOR_TYPE of the statement, SQL_CURSOR_FORWARD_ONLY by default.
+ * A scrollable cursor lets fetchAbsolute and fetchRelative move through the
+ * results; it must be set before the statement is prepared.
+ */
+
+NAN_GETTER(ODBCStatement::CursorTypeGetter) {
+  Nan::HandleScope scope;
+
+  ODBCStatement *obj = Nan::ObjectWrap::Unwrap<ODBCStatement>(info.Holder());
+
+  info.GetReturnValue().Set(Nan::New(obj->m_cursorType));
+}
+
+NAN_SETTER(ODBCStatement::CursorTypeSetter) {
+  Nan::HandleScope scope;
+
+  ODBCStatement *obj = Nan::ObjectWrap::Unwrap<ODBCStatement>(info.Holder());
+  
+  if (!value->IsInt32()) {
+    return;
+  }
+  
+  int cursorType = Nan::To<int32_t>(value).FromJust();
+  
+  SQLRETURN ret = SQLSetStmtAttr(obj->m_hSTMT, SQL_ATTR_CURSOR_TYPE, (SQLPOINTER) (intptr_t) cursorType, 0);
+  
+  if (!SQL_SUCCEEDED(ret)) {
+    Nan::ThrowError(ODBC::GetSQLError(
+      SQL_HANDLE_STMT,
+      obj->m_hSTMT,
+      (char *) "[node-informixdb] Error in ODBCStatement::CursorTypeSetter"
+    ));
+    return;
+  }
+  
+  obj->m_cursorType = cursorType;
+}
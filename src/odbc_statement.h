@@ -64,6 +64,10 @@ class ODBCStatement : public Nan::ObjectWrap {
     static void UV_Bind(uv_work_t* work_req);
     static void UV_AfterBind(uv_work_t* work_req, int status);
     
+    static NAN_METHOD(ExecuteBatch);
+    static void UV_ExecuteBatch(uv_work_t* work_req);
+    static void UV_AfterExecuteBatch(uv_work_t* work_req, int status);
+    
     //sync methods
     static NAN_METHOD(CloseSync);
     static NAN_METHOD(ExecuteSync);
@@ -71,6 +75,18 @@ class ODBCStatement : public Nan::ObjectWrap {
     static NAN_METHOD(ExecuteNonQuerySync);
     static NAN_METHOD(PrepareSync);
     static NAN_METHOD(BindSync);
+    static NAN_METHOD(ExecuteBatchSync);
+    
+    //property getter/setters
+    static NAN_GETTER(CursorTypeGetter);
+    static NAN_SETTER(CursorTypeSetter);
+    
+    Local<Object> NewResult();
+    void InvalidateColumns();
+    static bool BatchFailed(SQLULEN rowCount, SQLUSMALLINT* status, SQLULEN processed);
+    Local<Object> GetBatchResult(SQLULEN rowCount, SQLUSMALLINT* status, SQLULEN processed);
+    char* SetParameters(Local<Array> values);
+    void EndBatch();
     
     struct Fetch_Request {
       Nan::Callback* callback;
@@ -88,10 +104,20 @@ class ODBCStatement : public Nan::ObjectWrap {
     Parameter *params;
     int paramCount;
     
+    //memory of params, kept from one execution to the next
+    ParamArena paramArena;
+    
+    //the values of a bind that UpdateParameters copies into params
+    ParamArena rebindArena;
+    
     uint16_t *buffer;
     int bufferLength;
-    Column *columns;
-    short colCount;
+    
+    //SQL_ATTR_CURSOR_TYPE, set before the statement is prepared
+    int m_cursorType;
+    
+    //column metadata of the prepared statement, read on its first execution
+    ColumnCache *columnCache;
 };
 
 struct execute_direct_work_data {
@@ -120,6 +146,18 @@ struct bind_work_data {
   Nan::Callback* cb;
   ODBCStatement *stmt;
   int result;
+  char *changed;
+};
+
+struct execute_batch_work_data {
+  Nan::Callback* cb;
+  ODBCStatement *stmt;
+  int result;
+  ParameterArray *arrays;
+  int paramCount;
+  SQLULEN rowCount;
+  SQLUSMALLINT *status;
+  SQLULEN processed;
 };
 
 #endif
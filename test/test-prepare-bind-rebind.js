@@ -0,0 +1,61 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  ;
+
+// each bind reuses what it can of the parameters bound for the one before:
+// same types, a longer string, NULLs, a change of type and a CALL-style
+// [paramtype, ctype, sqltype, value] parameter
+var rows = [
+    [1, "short", 1.5]
+  , [2, "a longer string than the first one", 2.5]
+  , [3, null, null]
+  , [4, "back", 4.5]
+  , [5, "s", 5]
+  , [6, new Array(200).join("x"), 6.25]
+  , [7, "again", 7.75]
+  , [8, [1, 1, 12, "array form"], 8.5]
+  ];
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT VARCHAR(255), COLFLOAT FLOAT)");
+
+  var stmt = db.prepareSync("insert into " + common.tableName + " values (?, ?, ?)");
+
+  // the first half with bindSync, the rest with bind
+  rows.slice(0, 4).forEach(function (row) {
+    assert.equal(stmt.bindSync(row), true);
+    assert.equal(stmt.executeNonQuerySync(), 1);
+  });
+
+  (function next(i) {
+    if (i === rows.length) {
+      return check();
+    }
+    stmt.bind(rows[i], function (err) {
+      assert.equal(err, null);
+      stmt.executeNonQuery(function (err, count) {
+        assert.equal(err, null);
+        assert.equal(count, 1);
+        next(i + 1);
+      });
+    });
+  })(4);
+
+  function check() {
+    stmt.closeSync();
+
+    var data = db.querySync("select colint, coltext, colfloat from " + common.tableName + " order by colint");
+    assert.deepEqual(data, rows.map(function (row) {
+      var text = Array.isArray(row[1]) ? row[1][3] : row[1];
+      return { colint : row[0], coltext : text, colfloat : row[2] };
+    }));
+
+    common.dropTables(db, function () {
+      db.closeSync();
+    });
+  }
+});
@@ -0,0 +1,51 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , executions = 5
+  ;
+
+db.openSync(common.connectionString);
+
+common.dropTables(db, function () {
+  common.createTables(db, function (err) {
+    assert.equal(err, null);
+
+    db.querySync("insert into " + common.tableName + " (colint, coltext) values (1, 'one')");
+    db.querySync("insert into " + common.tableName + " (colint, coltext) values (2, 'two')");
+
+    var stmt = db.prepareSync("select colint, coltext from " + common.tableName + " where colint = ?");
+
+    // every execution shares the column metadata read by the first one
+    for (var i = 0; i < executions; i++) {
+      stmt.bindSync([1 + i % 2]);
+      var result = stmt.executeSync();
+      assert.deepEqual(result.getColumnNamesSync(), ["colint", "coltext"]);
+      assert.deepEqual(result.fetchAllSync(), [{ colint : 1 + i % 2, coltext : i % 2 ? "two" : "one" }]);
+      result.closeSync();
+    }
+
+    // a result alive when the statement is prepared again keeps its columns
+    stmt.bindSync([2]);
+    var open = stmt.executeSync();
+    assert.deepEqual(open.getColumnNamesSync(), ["colint", "coltext"]);
+    open.closeSync(odbc.SQL_CLOSE);
+
+    stmt.prepareSync("select coltext as label from " + common.tableName + " where colint = ?");
+    assert.deepEqual(open.getColumnNamesSync(), ["colint", "coltext"]);
+    open.closeSync();
+
+    stmt.bindSync([2]);
+    stmt.execute(function (err, result) {
+      assert.equal(err, null);
+      assert.deepEqual(result.getColumnNamesSync(), ["label"]);
+      assert.deepEqual(result.fetchAllSync(), [{ label : "two" }]);
+      result.closeSync();
+      stmt.closeSync();
+
+      common.dropTables(db, function () {
+        db.closeSync();
+      });
+    });
+  });
+});
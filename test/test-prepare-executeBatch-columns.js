@@ -0,0 +1,88 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 100
+  , ids = new Int32Array(rowCount)
+  , readings = new Float64Array(rowCount)
+  , totals = new BigInt64Array(rowCount)
+  , nulls = Buffer.alloc(Math.ceil(rowCount / 8))
+  , labels = []
+  ;
+
+for (var i = 0; i < rowCount; i++) {
+  ids[i] = i;
+  readings[i] = i / 8;
+  totals[i] = BigInt(i) * 10000000000n;
+  labels.push(i % 5 ? "sensor " + i : null);
+  // every seventh reading is NULL
+  if (i % 7 === 0) {
+    nulls[i >> 3] |= 1 << (i & 7);
+  }
+}
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLFLOAT FLOAT, COLBIGINT BIGINT, COLTEXT VARCHAR(20))");
+
+  var sql = "insert into " + common.tableName + " values (?, ?, ?, ?)";
+  var columns = [ids, { values : readings, nulls : nulls }, totals, labels];
+
+  // batches of 24 rows, so that the nulls are sliced at a byte boundary
+  db.executeBatch(sql, { columns : columns }, { batchSize : 30 }, function (err, result) {
+    assert.equal(err, null);
+    assert.equal(result.count, rowCount);
+    assert.deepEqual(result.failed, []);
+
+    var data = db.querySync("select colint, colfloat, colbigint, coltext from " + common.tableName + " order by colint");
+    assert.equal(data.length, rowCount);
+    data.forEach(function (row, i) {
+      assert.equal(row.colint, i);
+      assert.equal(row.colfloat, i % 7 === 0 ? null : i / 8);
+      assert.equal(String(row.colbigint), String(totals[i]));
+      assert.equal(row.coltext, labels[i]);
+    });
+
+    var stmt = db.prepareSync(sql);
+
+    // columns of different lengths
+    assert.throws(function () {
+      stmt.executeBatchSync({ columns : [new Int32Array(2), new Float64Array(3), totals.subarray(0, 2), ["a", "b"]] });
+    });
+    assert.throws(function () {
+      stmt.executeBatchSync({ columns : [new Uint16Array(2), new Float64Array(2), totals.subarray(0, 2), ["a", "b"]] });
+    });
+
+    result = stmt.executeBatchSync({ columns : [Int32Array.of(1000, 1001), Float64Array.of(1.5, 2.5), BigInt64Array.of(1n, 2n), ["x", null]] });
+    assert.equal(result.count, 2);
+    stmt.closeSync();
+
+    // the columns of FETCH_COLUMNAR go back in as they are
+    var copy = db.queryResultSync("select colint + 2000, colfloat, colbigint, coltext from " + common.tableName + " where colint < " + rowCount + " order by colint");
+    var vectors = copy.fetchAllSync({ fetchMode : odbc.FETCH_COLUMNAR });
+    copy.closeSync();
+
+    stmt = db.prepareSync(sql);
+    stmt.executeBatch({ columns : vectors }, function (err, result) {
+      assert.equal(err, null);
+      assert.equal(result.count, rowCount);
+      stmt.closeSync();
+
+      var data = db.querySync("select colint, colfloat, coltext from " + common.tableName + " where colint >= 2000 order by colint");
+      assert.equal(data.length, rowCount);
+      data.forEach(function (row, i) {
+        assert.equal(row.colint, i + 2000);
+        assert.equal(row.colfloat, i % 7 === 0 ? null : i / 8);
+        assert.equal(row.coltext, labels[i]);
+      });
+
+      common.dropTables(db, function () {
+        db.closeSync();
+      });
+    });
+
+    // the values of the only batch were copied when it started
+    vectors[0].values.fill(-1);
+  });
+});
@@ -0,0 +1,72 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 2500
+  , rows = []
+  ;
+
+for (var i = 0; i < rowCount; i++) {
+  // a NULL every 10 rows, and floats mixed with integers
+  rows.push([i, i % 10 === 0 ? null : "row " + i, i % 2 ? i / 4 : i]);
+}
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER PRIMARY KEY, COLTEXT VARCHAR(40), COLFLOAT FLOAT)");
+
+  var sql = "insert into " + common.tableName + " values (?, ?, ?)";
+
+  db.executeBatch(sql, rows, { batchSize : 1000 }, function (err, result) {
+    assert.equal(err, null);
+    assert.equal(result.count, rowCount);
+    assert.equal(result.processed, rowCount);
+    assert.deepEqual(result.failed, []);
+
+    var data = db.querySync("select colint, coltext, colfloat from " + common.tableName + " order by colint");
+    assert.equal(data.length, rowCount);
+    data.forEach(function (row, i) {
+      assert.deepEqual(row, { colint : i, coltext : rows[i][1], colfloat : rows[i][2] });
+    });
+
+    // rows 1 and 3 break the primary key
+    var stmt = db.prepareSync(sql);
+    assert.throws(function () {
+      stmt.executeBatchSync([[rowCount, "new", 1], [0, "dup", 2], [rowCount + 1, "new", 3], [1, "dup", 4]]);
+    }, function (err) {
+      assert.deepEqual(err.result.failed, [1, 3]);
+      // the diagnostic of the driver is still there
+      assert.ok(err.state, "no SQLSTATE in the error of the batch");
+      assert.ok(err.message, "no message in the error of the batch");
+      return true;
+    });
+
+    // the rows of a batch must all have one value per parameter
+    assert.throws(function () {
+      stmt.executeBatchSync([[1, "a", 1], [2, "b"]]);
+    });
+
+    // the statement still runs with single parameters afterwards
+    assert.equal(stmt.bindSync([rowCount + 10, "single", 0.5]), true);
+    assert.equal(stmt.executeNonQuerySync(), 1);
+    stmt.closeSync();
+
+    db.prepare(sql, function (err, stmt) {
+      assert.equal(err, null);
+
+      stmt.executeBatch([[rowCount + 20, "text", 0.5], [rowCount + 21, 42, null]], function (err, result) {
+        assert.equal(err, null);
+        assert.equal(result.count, 2);
+        stmt.closeSync();
+
+        assert.deepEqual(db.querySync("select coltext from " + common.tableName + " where colint = " + (rowCount + 21)),
+          [{ coltext : "42" }]);
+
+        common.dropTables(db, function () {
+          db.closeSync();
+        });
+      });
+    });
+  });
+});
@@ -0,0 +1,54 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLBIG BIGINT, COLDEC DECIMAL(12,2))");
+  db.querySync("insert into " + common.tableName + " values (1, 9007199254740993, 1234567.89)");
+  db.querySync("insert into " + common.tableName + " values (2, -42, -0.5)");
+  db.querySync("insert into " + common.tableName + " values (3, null, null)");
+
+  var sql = "select colbig, coldec from " + common.tableName + " order by colint";
+
+  // strings stay the default
+  var data = db.querySync(sql);
+  assert.strictEqual(data[0].colbig, "9007199254740993");
+  assert.strictEqual(data[1].colbig, "-42");
+  assert.strictEqual(typeof data[0].coldec, "string");
+
+  var result = db.queryResultSync(sql);
+  result.bigintMode = odbc.BIGINT_BIGINT;
+  result.decimalMode = odbc.DECIMAL_NUMBER;
+  assert.equal(result.bigintMode, odbc.BIGINT_BIGINT);
+  assert.equal(result.decimalMode, odbc.DECIMAL_NUMBER);
+  data = result.fetchAllSync();
+  result.closeSync();
+
+  assert.strictEqual(data[0].colbig, BigInt("9007199254740993"));
+  assert.strictEqual(data[1].colbig, BigInt(-42));
+  assert.strictEqual(data[0].coldec, 1234567.89);
+  assert.strictEqual(data[1].coldec, -0.5);
+  assert.deepEqual(data[2], { colbig : null, coldec : null });
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+    result.bigintMode = odbc.BIGINT_NUMBER;
+    result.decimalMode = odbc.DECIMAL_NUMBER;
+
+    result.fetchAll(function (err, data) {
+      assert.equal(err, null);
+      assert.strictEqual(data[1].colbig, -42);
+      assert.strictEqual(data[1].coldec, -0.5);
+      assert.deepEqual(data[2], { colbig : null, coldec : null });
+      result.closeSync();
+
+      common.dropTables(db, function () {
+        db.closeSync();
+      });
+    });
+  });
+});
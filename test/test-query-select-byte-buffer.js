@@ -0,0 +1,40 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  ;
+
+db.openSync(common.connectionString);
+
+// all 256 byte values, repeated to be bigger than the initial row buffer
+var bytes = Buffer.alloc(256 * 200);
+for (var i = 0; i < bytes.length; i++) {
+  bytes[i] = i % 256;
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLBYTE BYTE)");
+  db.querySync("insert into " + common.tableName + " (colint, colbyte) values (?, ?)",
+               [1, { DataType : "BYTE", Data : bytes.toString("binary") }]);
+  db.querySync("insert into " + common.tableName + " (colint) values (2)");
+
+  var sql = "select colint, colbyte from " + common.tableName + " order by colint";
+
+  function check(data) {
+    assert.equal(data.length, 2);
+    assert.ok(Buffer.isBuffer(data[0].colbyte));
+    assert.ok(data[0].colbyte.equals(bytes));
+    assert.equal(data[1].colbyte, null);
+  }
+
+  check(db.querySync(sql));
+
+  db.query(sql, function (err, data) {
+    assert.equal(err, null);
+    check(data);
+
+    common.dropTables(db, function () {
+      db.closeSync();
+    });
+  });
+});
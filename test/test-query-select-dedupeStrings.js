@@ -0,0 +1,62 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database({ dedupeStrings : true })
+  , assert = require("assert")
+  , rowCount = 1200
+  , codes = ["NEW", "PAID", "SHIPPED", "CANCELLED"]
+  ;
+
+db.openSync(common.connectionString);
+
+function status(i) {
+  // a long value every 7 rows, never kept in the dictionary
+  return i % 7 === 0 ? new Array(101).join(codes[i % 4].charAt(0)) : codes[i % 4];
+}
+
+function check(rows) {
+  assert.equal(rows.length, rowCount);
+  rows.forEach(function (row, i) {
+    assert.equal(row.colint, i);
+    // more distinct values than the dictionary keeps
+    assert.equal(row.colcode, i % 3 === 0 ? null : "c" + i);
+    assert.equal(row.colstatus, status(i));
+  });
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLCODE CHAR(8), COLSTATUS VARCHAR(200))");
+  db.beginTransactionSync();
+  for (var i = 0; i < rowCount; i++) {
+    db.querySync("insert into " + common.tableName + " values (?, ?, ?)",
+      [i, i % 3 === 0 ? null : "c" + i, status(i)]);
+  }
+  db.commitTransactionSync();
+
+  var sql = "select colint, trim(colcode) as colcode, colstatus from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+    assert.equal(result.dedupeStrings, true);
+
+    result.fetchAll({ rowsetSize : 100 }, function (err, data) {
+      assert.equal(err, null);
+      check(data);
+      result.closeSync();
+
+      // one row at a time through SQLGetData
+      var result2 = db.queryResultSync(sql), row, rows = [];
+      while ((row = result2.fetchSync())) {
+        rows.push(row);
+      }
+      check(rows);
+
+      result2.dedupeStrings = false;
+      assert.equal(result2.dedupeStrings, false);
+      result2.closeSync();
+
+      common.dropTables(db, function () {
+        db.closeSync();
+      });
+    });
+  });
+});
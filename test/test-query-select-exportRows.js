@@ -0,0 +1,77 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , fs = require("fs")
+  , os = require("os")
+  , path = require("path")
+  , rowCount = 100
+  , csvPath = path.join(os.tmpdir(), "informixdb-export-" + process.pid + ".csv")
+  , jsonPath = path.join(os.tmpdir(), "informixdb-export-" + process.pid + ".ndjson")
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLFLOAT FLOAT, COLTEXT VARCHAR(255))");
+  db.beginTransactionSync();
+  for (var i = 0; i < rowCount; i++) {
+    if (i % 10 === 0) {
+      db.querySync("insert into " + common.tableName + " (colint) values (?)", [i]);
+    }
+    else {
+      db.querySync("insert into " + common.tableName + " values (?, ?, ?)", [i, i / 4, "row, " + i]);
+    }
+  }
+  db.commitTransactionSync();
+
+  var sql = "select colint, colfloat, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    result.exportRows({ format : 'csv', path : csvPath }, function (err, count) {
+      assert.equal(err, null);
+      assert.equal(count, rowCount);
+      result.closeSync();
+
+      var lines = fs.readFileSync(csvPath, "utf8").split("\n");
+      fs.unlinkSync(csvPath);
+
+      assert.equal(lines.length, rowCount + 2);
+      assert.equal(lines[0], "colint,colfloat,coltext");
+      assert.equal(lines[1], "0,,");
+      assert.equal(lines[2], "1,0.25,\"row, 1\"");
+      assert.equal(lines[rowCount + 1], "");
+
+      // the same as NDJSON through bound rowsets and an fd
+      var fd = fs.openSync(jsonPath, "w"), progress = 0;
+
+      db.exportQuery({ sql : sql, rowsetSize : 32 }, { format : 'ndjson', fd : fd, progress : function (count) {
+        progress = count;
+      }}, function (err, count) {
+        assert.equal(err, null);
+        assert.equal(count, rowCount);
+        assert.ok(progress <= count);
+        fs.closeSync(fd);
+
+        var rows = fs.readFileSync(jsonPath, "utf8").trim().split("\n").map(function (line) {
+          return JSON.parse(line);
+        });
+        fs.unlinkSync(jsonPath);
+
+        assert.equal(rows.length, rowCount);
+        assert.deepEqual(rows[0], { colint : 0, colfloat : null, coltext : null });
+        assert.deepEqual(rows[1], { colint : 1, colfloat : 0.25, coltext : "row, 1" });
+
+        db.exportQuery(sql, { format : 'xml', path : csvPath }, function (err) {
+          assert.ok(err);
+
+          common.dropTables(db, function () {
+            db.closeSync();
+          });
+        });
+      });
+    });
+  });
+});
@@ -0,0 +1,45 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , longText = new Array(20001).join("x")
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  // wider than the initial row buffer so the worker has to grow it
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT LVARCHAR(30000))");
+  db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)", [1, longText]);
+  db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)", [2, null]);
+
+  var sql = "select colint, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    result.fetch(function (err, data) {
+      assert.equal(err, null);
+      assert.equal(data.colint, 1);
+      assert.equal(data.coltext.length, longText.length);
+      assert.equal(data.coltext, longText);
+
+      result.fetch(function (err, data) {
+        assert.equal(err, null);
+        assert.deepEqual(data, { colint : 2, coltext : null });
+        result.closeSync();
+
+        db.query(sql, function (err, data) {
+          assert.equal(err, null);
+          assert.equal(data.length, 2);
+          assert.equal(data[0].coltext, longText);
+          assert.equal(data[1].coltext, null);
+
+          common.dropTables(db, function () {
+            db.closeSync();
+          });
+        });
+      });
+    });
+  });
+});
@@ -0,0 +1,87 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 25
+  ;
+
+db.openSync(common.connectionString);
+
+function page(rows, from, count) {
+  assert.equal(rows.length, count);
+  rows.forEach(function (row, i) {
+    assert.deepEqual(row, { colint : from + i, coltext : "row " + (from + i) });
+  });
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT VARCHAR(20))");
+
+  for (var i = 0; i < rowCount; i++) {
+    db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)", [i, "row " + i]);
+  }
+
+  var sql = "select colint, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult({ sql : sql, cursorType : odbc.SQL_CURSOR_STATIC }, function (err, result) {
+    assert.equal(err, null);
+
+    // the third page of 5, then back to the first and forward again
+    result.fetchAbsolute(11, 5, function (err, rows, exhausted) {
+      assert.equal(err, null);
+      assert.equal(exhausted, false);
+      page(rows, 10, 5);
+
+      result.fetchRelative(-10, 5, function (err, rows, exhausted) {
+        assert.equal(err, null);
+        page(rows, 0, 5);
+
+        result.fetchRelative(5, 5, function (err, rows) {
+          assert.equal(err, null);
+          page(rows, 5, 5);
+
+          // the last page is short, and the cursor can still go back from it
+          result.fetchAbsolute(21, 10, function (err, rows, exhausted) {
+            assert.equal(err, null);
+            assert.equal(exhausted, true);
+            page(rows, 20, 5);
+
+            result.fetchAbsolute(-1, 1, function (err, rows) {
+              assert.equal(err, null);
+              page(rows, rowCount - 1, 1);
+
+              result.fetchAbsolute(1, 2, { fetchMode : odbc.FETCH_ARRAY }, function (err, rows) {
+                assert.equal(err, null);
+                assert.deepEqual(rows, [[0, "row 0"], [1, "row 1"]]);
+                result.closeSync();
+
+                // a prepared statement with a scrollable cursor
+                var stmt = db.prepareSync({ sql : sql, cursorType : odbc.SQL_CURSOR_STATIC });
+                assert.equal(stmt.cursorType, odbc.SQL_CURSOR_STATIC);
+
+                stmt.execute(function (err, result) {
+                  assert.equal(err, null);
+
+                  result.fetchAbsolute(24, 1, function (err, rows) {
+                    assert.equal(err, null);
+                    page(rows, 23, 1);
+                    result.closeSync();
+                    stmt.closeSync();
+
+                    assert.throws(function () {
+                      result.fetchAbsolute("1", 5, function () {});
+                    });
+
+                    common.dropTables(db, function () {
+                      db.closeSync();
+                    });
+                  });
+                });
+              });
+            });
+          });
+        });
+      });
+    });
+  });
+});
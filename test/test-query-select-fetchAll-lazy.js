@@ -0,0 +1,61 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 600
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLFLOAT FLOAT, COLTEXT VARCHAR(255))");
+  db.beginTransactionSync();
+  for (var i = 0; i < rowCount; i++) {
+    if (i % 10 === 0) {
+      db.querySync("insert into " + common.tableName + " (colint) values (?)", [i]);
+    }
+    else {
+      db.querySync("insert into " + common.tableName + " values (?, ?, ?)", [i, i / 4, "row " + i]);
+    }
+  }
+  db.commitTransactionSync();
+
+  var sql = "select colint, colfloat, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    // more rows than one block of the default size
+    result.fetchAll({ fetchMode : odbc.FETCH_LAZY }, function (err, data) {
+      assert.equal(err, null);
+      assert.equal(data.length, rowCount);
+      result.closeSync();
+
+      // the values are still there once the result is closed
+      data.forEach(function (row, i) {
+        assert.equal(row.colint, i);
+        assert.equal(row.colfloat, i % 10 === 0 ? null : i / 4);
+        assert.equal(row.coltext, i % 10 === 0 ? null : "row " + i);
+      });
+
+      assert.deepEqual(Object.keys(data[1]), ["colint", "colfloat", "coltext"]);
+      assert.deepEqual(JSON.parse(JSON.stringify(data[1])), { colint : 1, colfloat : 0.25, coltext : "row 1" });
+      assert.deepEqual(Object.assign({}, data[0]), { colint : 0, colfloat : null, coltext : null });
+
+      db.queryResult(sql, function (err, result) {
+        assert.equal(err, null);
+
+        result.fetchMany(3, { fetchMode : odbc.FETCH_LAZY }, function (err, rows) {
+          assert.equal(err, null);
+          assert.equal(rows.length, 3);
+          assert.equal(rows[2].coltext, "row 2");
+          result.closeSync();
+
+          common.dropTables(db, function () {
+            db.closeSync();
+          });
+        });
+      });
+    });
+  });
+});
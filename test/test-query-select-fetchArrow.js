@@ -0,0 +1,84 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 100
+  ;
+
+db.openSync(common.connectionString);
+
+// splits an Arrow IPC stream into its messages
+function messages(buffer) {
+  var list = [], pos = 0;
+
+  while (true) {
+    assert.equal(buffer.readInt32LE(pos), -1);
+    var length = buffer.readInt32LE(pos + 4);
+    if (length === 0) break;
+    assert.equal(length % 8, 0);
+    list.push({ metadata : buffer.slice(pos + 8, pos + 8 + length), start : pos + 8 + length });
+    pos += 8 + length;
+    if (list.length === 2) {
+      // the body of the record batch runs up to the end-of-stream marker
+      pos = buffer.length - 8;
+    }
+  }
+
+  assert.equal(pos, buffer.length - 8);
+  return list;
+}
+
+function check(buffer) {
+  assert.ok(Buffer.isBuffer(buffer));
+
+  var list = messages(buffer);
+  assert.equal(list.length, 2);
+
+  // field names are in the schema
+  ["colint", "colfloat", "coltext"].forEach(function (name) {
+    assert.notEqual(list[0].metadata.indexOf(name), -1);
+  });
+
+  // colint has no NULL so its values open the body
+  var body = buffer.slice(list[1].start, buffer.length - 8);
+  for (var i = 0; i < rowCount; i++) {
+    assert.equal(body.readInt32LE(i * 4), i);
+  }
+  assert.notEqual(body.indexOf("row " + (rowCount - 1)), -1);
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLFLOAT FLOAT, COLTEXT VARCHAR(255))");
+  db.beginTransactionSync();
+  for (var i = 0; i < rowCount; i++) {
+    if (i % 10 === 0) {
+      db.querySync("insert into " + common.tableName + " (colint) values (?)", [i]);
+    }
+    else {
+      db.querySync("insert into " + common.tableName + " values (?, ?, ?)", [i, i / 4, "row " + i]);
+    }
+  }
+  db.commitTransactionSync();
+
+  var sql = "select colint, colfloat, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    result.fetchArrow(function (err, buffer) {
+      assert.equal(err, null);
+      check(buffer);
+      result.closeSync();
+
+      // the same through bound rowsets
+      db.queryArrow({ sql : sql, rowsetSize : 32 }, function (err, buffer) {
+        assert.equal(err, null);
+        check(buffer);
+
+        common.dropTables(db, function () {
+          db.closeSync();
+        });
+      });
+    });
+  });
+});
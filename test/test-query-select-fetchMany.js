@@ -0,0 +1,85 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 25
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT VARCHAR(20))");
+
+  for (var i = 0; i < rowCount; i++) {
+    db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)", [i, "row " + i]);
+  }
+
+  var sql = "select colint, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    var seen = 0, batches = [];
+
+    (function next(count) {
+      result.fetchMany(count, function (err, rows, exhausted) {
+        assert.equal(err, null);
+        assert.ok(rows.length <= count);
+
+        rows.forEach(function (row) {
+          assert.deepEqual(row, { colint : seen, coltext : "row " + seen });
+          seen++;
+        });
+        batches.push(rows.length);
+
+        if (!exhausted) {
+          // batches of changing size, single rows included
+          return next(batches.length % 3 === 1 ? 1 : 10);
+        }
+
+        assert.equal(seen, rowCount);
+        result.closeSync();
+
+        db.queryResult(sql, function (err, result) {
+          assert.equal(err, null);
+
+          result.fetchMany(2, { fetchMode : odbc.FETCH_ARRAY }, function (err, rows, exhausted) {
+            assert.equal(err, null);
+            assert.equal(exhausted, false);
+            assert.deepEqual(rows, [[0, "row 0"], [1, "row 1"]]);
+
+            // one row at a time again after a batch
+            result.fetch(function (err, row) {
+              assert.equal(err, null);
+              assert.deepEqual(row, { colint : 2, coltext : "row 2" });
+              result.closeSync();
+
+              assert.throws(function () {
+                result.fetchMany(0, function () {});
+              });
+
+              db.queryResult(sql, function (err, result) {
+                assert.equal(err, null);
+
+                result.fetchMany(2, function (err, rows, exhausted) {
+                  assert.equal(err, null);
+                  assert.equal(exhausted, false);
+                  assert.equal(rows.length, 2);
+
+                  // the sync paths drop the rowset too
+                  assert.deepEqual(result.fetchSync(), { colint : 2, coltext : "row 2" });
+                  assert.equal(result.fetchAllSync().length, rowCount - 3);
+                  result.closeSync();
+
+                  common.dropTables(db, function () {
+                    db.closeSync();
+                  });
+                });
+              });
+            });
+          });
+        });
+      });
+    })(10);
+  });
+});
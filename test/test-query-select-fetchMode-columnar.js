@@ -0,0 +1,94 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , rowCount = 3000
+  ;
+
+db.openSync(common.connectionString);
+
+function isNull(column, row) {
+  return (column.nulls[row >> 3] & (1 << (row & 7))) !== 0;
+}
+
+function text(column, row) {
+  return column.values.toString("utf8", column.offsets[row], column.offsets[row + 1]);
+}
+
+function check(data) {
+  assert.equal(data.length, 3);
+  assert.deepEqual(data.map(function (column) { return column.name; }),
+                   ["colint", "colfloat", "coltext"]);
+
+  var colint = data[0], colfloat = data[1], coltext = data[2];
+
+  assert.ok(colint.values instanceof Int32Array);
+  assert.ok(colfloat.values instanceof Float64Array);
+  assert.ok(coltext.offsets instanceof Int32Array);
+  assert.equal(colint.rowCount, rowCount);
+  assert.equal(colint.values.length, rowCount);
+  assert.equal(coltext.offsets.length, rowCount + 1);
+
+  for (var i = 0; i < rowCount; i++) {
+    assert.equal(colint.values[i], i);
+    assert.equal(isNull(colint, i), false);
+
+    // every tenth row has NULL in the last two columns
+    if (i % 10 === 0) {
+      assert.equal(isNull(colfloat, i), true);
+      assert.equal(isNull(coltext, i), true);
+      assert.equal(colfloat.values[i], 0);
+      assert.equal(text(coltext, i), "");
+    }
+    else {
+      assert.equal(isNull(colfloat, i), false);
+      assert.equal(colfloat.values[i], i / 4);
+      assert.equal(text(coltext, i), "row " + i);
+    }
+  }
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLFLOAT FLOAT, COLTEXT VARCHAR(255))");
+  db.beginTransactionSync();
+  for (var i = 0; i < rowCount; i++) {
+    if (i % 10 === 0) {
+      db.querySync("insert into " + common.tableName + " (colint) values (?)", [i]);
+    }
+    else {
+      db.querySync("insert into " + common.tableName + " values (?, ?, ?)", [i, i / 4, "row " + i]);
+    }
+  }
+  db.commitTransactionSync();
+
+  var sql = "select colint, colfloat, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    result.fetchAll({ fetchMode : odbc.FETCH_COLUMNAR }, function (err, data) {
+      assert.equal(err, null);
+      check(data);
+      result.closeSync();
+
+      // the same through bound rowsets
+      db.queryResult({ sql : sql, rowsetSize : 100 }, function (err, result) {
+        assert.equal(err, null);
+
+        result.fetchAll({ fetchMode : odbc.FETCH_COLUMNAR }, function (err, data) {
+          assert.equal(err, null);
+          check(data);
+          result.closeSync();
+
+          result = db.queryResultSync(sql);
+          check(result.fetchAllSync({ fetchMode : odbc.FETCH_COLUMNAR }));
+          result.closeSync();
+
+          common.dropTables(db, function () {
+            db.closeSync();
+          });
+        });
+      });
+    });
+  });
+});
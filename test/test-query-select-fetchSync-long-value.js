@@ -0,0 +1,44 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , lengths = [10, 5000, 20000, 300, 20000, 8000]
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT LVARCHAR(30000))");
+
+  lengths.forEach(function (length, i) {
+    db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)",
+      [i, new Array(length + 1).join(String.fromCharCode(97 + i))]);
+  });
+
+  var sql = "select colint, coltext from " + common.tableName + " order by colint";
+
+  [undefined, 4096].forEach(function (maxBufferSize) {
+    var result = db.queryResultSync(sql), data, i = 0;
+
+    assert.equal(result.maxBufferSize, 1024 * 1024);
+    if (maxBufferSize) {
+      result.maxBufferSize = maxBufferSize;
+      assert.equal(result.maxBufferSize, maxBufferSize);
+    }
+
+    // the buffer grown for a long value must not leak into shorter ones
+    while ((data = result.fetchSync())) {
+      assert.equal(data.colint, i);
+      assert.equal(data.coltext.length, lengths[i]);
+      assert.equal(data.coltext, new Array(lengths[i] + 1).join(String.fromCharCode(97 + i)));
+      i++;
+    }
+
+    assert.equal(i, lengths.length);
+    result.closeSync();
+  });
+
+  common.dropTables(db, function () {
+    db.closeSync();
+  });
+});
@@ -0,0 +1,86 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , text = new Array(200001).join("t")
+  ;
+
+db.openSync(common.connectionString);
+
+function readAll(stream, cb) {
+  var chunks = [];
+  stream.on("data", function (chunk) { chunks.push(chunk); });
+  stream.on("error", cb);
+  stream.on("end", function () { cb(null, Buffer.concat(chunks)); });
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT TEXT)");
+  db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)",
+               [1, { DataType : "TEXT", Data : text }]);
+  db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)",
+               [2, { DataType : "TEXT", Data : "short" }]);
+  db.querySync("insert into " + common.tableName + " (colint) values (3)");
+
+  var sql = "select colint, coltext from " + common.tableName + " order by colint";
+
+  db.queryResult(sql, function (err, result) {
+    assert.equal(err, null);
+
+    // a value spanning several chunks
+    result.fetch({ lobStream : true }, function (err, row) {
+      assert.equal(err, null);
+      assert.equal(row.colint, 1);
+      assert.ok(row.coltext instanceof require("stream").Readable);
+
+      readAll(row.coltext, function (err, data) {
+        assert.equal(err, null);
+        assert.equal(data.toString(), text);
+
+        // a value read with the first chunk, in array mode
+        result.fetch({ lobStream : true, fetchMode : odbc.FETCH_ARRAY }, function (err, row) {
+          assert.equal(err, null);
+          assert.equal(row[0], 2);
+          assert.ok(row[1] instanceof require("stream").Readable);
+
+          // moving on without reading the stream closes it
+          result.fetch({ lobStream : true }, function (err, row) {
+            assert.equal(err, null);
+            assert.equal(row.colint, 3);
+            assert.equal(row.coltext, null);
+
+            result.fetch(function (err, row) {
+              assert.equal(err, null);
+              assert.equal(row, null);
+              result.closeSync();
+
+              // with a repeated label the streamed column is not the last key
+              var dup = "select colint as x, colint as y, coltext as x from " + common.tableName +
+                        " where colint = 2";
+
+              db.queryResult(dup, function (err, result) {
+                assert.equal(err, null);
+
+                result.fetch({ lobStream : true }, function (err, row) {
+                  assert.equal(err, null);
+                  assert.equal(row.y, 2);
+                  assert.ok(row.x instanceof require("stream").Readable);
+
+                  readAll(row.x, function (err, data) {
+                    assert.equal(err, null);
+                    assert.equal(data.toString(), "short");
+                    result.closeSync();
+
+                    common.dropTables(db, function () {
+                      db.closeSync();
+                    });
+                  });
+                });
+              });
+            });
+          });
+        });
+      });
+    });
+  });
+});
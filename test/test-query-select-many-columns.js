@@ -0,0 +1,31 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , columnCount = 200
+  ;
+
+db.openSync(common.connectionString);
+
+// labels of every length share one block with the column array
+var labels = [], select = [], expected = {};
+for (var i = 0; i < columnCount; i++) {
+  var label = "c" + new Array(i % 40 + 1).join("x") + i;
+  labels.push(label);
+  select.push(i + " as " + label);
+  expected[label] = i;
+}
+
+var sql = "select " + select.join(", ") + " from systables where tabid = 1";
+
+var result = db.queryResultSync(sql);
+assert.deepEqual(result.getColumnNamesSync(), labels);
+assert.deepEqual(result.fetchAllSync(), [expected]);
+result.closeSync();
+
+db.query(sql, function (err, data) {
+  assert.equal(err, null);
+  assert.deepEqual(data, [expected]);
+
+  db.closeSync();
+});
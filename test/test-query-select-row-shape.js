@@ -0,0 +1,28 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  ;
+
+db.openSync(common.connectionString);
+
+var sql = "select 1 as COLA, 'b' as COLB, 3.5 as COLC from TABLE(SET{1,2,3})";
+
+db.query(sql, function (err, data) {
+  assert.equal(err, null);
+  assert.equal(data.length, 3);
+
+  // every row carries the columns in select list order
+  data.forEach(function (row) {
+    assert.deepEqual(Object.keys(row), ["cola", "colb", "colc"]);
+  });
+
+  // rows created from the same result set do not share values
+  data[0].colb = "changed";
+  assert.equal(data[1].colb, "b");
+
+  var rows = db.querySync(sql);
+  assert.deepEqual(Object.keys(rows[2]), ["cola", "colb", "colc"]);
+
+  db.closeSync();
+});
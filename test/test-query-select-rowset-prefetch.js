@@ -0,0 +1,48 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database({ rowsetSize : 8, prefetch : true })
+  , assert = require("assert")
+  , rowCount = 50
+  ;
+
+db.openSync(common.connectionString);
+
+common.dropTables(db, function () {
+  common.createTables(db, function (err) {
+    assert.equal(err, null);
+
+    for (var i = 0; i < rowCount; i++) {
+      db.querySync("insert into " + common.tableName +
+                   " (colint, coltext) values (?, ?)", [i, "row " + i]);
+    }
+
+    var sql = "select colint, coltext from " + common.tableName + " order by colint";
+    var expected = db.querySync(sql);
+    assert.equal(expected.length, rowCount);
+
+    // prefetch of the connection: the blocks alternate between both sets
+    db.query(sql, function (err, data) {
+      assert.equal(err, null);
+      assert.deepEqual(data, expected);
+
+      db.queryResult(sql, function (err, result) {
+        assert.equal(err, null);
+        assert.equal(result.prefetch, true);
+
+        // a row count that is a multiple of the block size ends on an empty fetch
+        result.fetchAll({ fetchMode : odbc.FETCH_ARRAY, rowsetSize : 10, prefetch : true }, function (err, data) {
+          assert.equal(err, null);
+          assert.equal(data.length, rowCount);
+          data.forEach(function (row, i) {
+            assert.deepEqual(row, [expected[i].colint, expected[i].coltext]);
+          });
+          result.closeSync();
+
+          common.dropTables(db, function () {
+            db.closeSync();
+          });
+        });
+      });
+    });
+  });
+});
@@ -0,0 +1,53 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database({ rowsetSize : 10 })
+  , assert = require("assert")
+  , rowCount = 25
+  ;
+
+db.openSync(common.connectionString);
+
+common.dropTables(db, function () {
+  common.createTables(db, function (err) {
+    assert.equal(err, null);
+
+    for (var i = 0; i < rowCount; i++) {
+      db.querySync("insert into " + common.tableName +
+                   " (colint, coltext) values (?, ?)", [i, "row " + i]);
+    }
+
+    var sql = "select colint, coltext from " + common.tableName + " order by colint";
+    var expected = db.querySync(sql);
+    assert.equal(expected.length, rowCount);
+
+    // rowsetSize of the connection: three blocks, the last one partial
+    db.query(sql, function (err, data) {
+      assert.equal(err, null);
+      assert.deepEqual(data, expected);
+
+      // rowsetSize of the query object
+      db.query({ sql : sql, rowsetSize : 4 }, function (err, data) {
+        assert.equal(err, null);
+        assert.deepEqual(data, expected);
+
+        // rowsetSize passed to fetchAll
+        db.queryResult(sql, function (err, result) {
+          assert.equal(err, null);
+          assert.equal(result.rowsetSize, 10);
+
+          result.fetchAll({ fetchMode : odbc.FETCH_ARRAY, rowsetSize : 7 }, function (err, data) {
+            assert.equal(err, null);
+            assert.equal(data.length, rowCount);
+            assert.deepEqual(data[rowCount - 1], [expected[rowCount - 1].colint,
+                                                  expected[rowCount - 1].coltext]);
+            result.closeSync();
+
+            common.dropTables(db, function () {
+              db.closeSync();
+            });
+          });
+        });
+      });
+    });
+  });
+});
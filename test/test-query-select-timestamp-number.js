@@ -0,0 +1,55 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database({ timestampAsNumber : true })
+  , assert = require("assert")
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLDT DATETIME YEAR TO FRACTION(3))");
+  db.querySync("insert into " + common.tableName + " (colint, coldt) values (1, '1969-12-31 23:59:59.250')");
+  db.querySync("insert into " + common.tableName + " (colint, coldt) values (2, '2024-02-29 12:34:56.789')");
+  db.querySync("insert into " + common.tableName + " (colint, coldt) values (3, null)");
+
+  var sql = "select colint, coldt from " + common.tableName + " order by colint";
+  // DATETIME values are local times
+  var expected = [
+    new Date(1969, 11, 31, 23, 59, 59, 250).getTime(),
+    new Date(2024, 1, 29, 12, 34, 56, 789).getTime(),
+    null
+  ];
+
+  function check(data) {
+    assert.equal(data.length, 3);
+    data.forEach(function (row, i) {
+      assert.strictEqual(row.coldt, expected[i]);
+    });
+  }
+
+  var result = db.queryResultSync(sql);
+  assert.equal(result.timestampAsNumber, true);
+  check(result.fetchAllSync());
+  result.closeSync();
+
+  db.query(sql, function (err, data) {
+    assert.equal(err, null);
+    check(data);
+
+    db.queryResult(sql, function (err, result) {
+      assert.equal(err, null);
+      result.timestampAsNumber = false;
+      assert.equal(result.timestampAsNumber, false);
+
+      result.fetchAll(function (err, data) {
+        assert.equal(err, null);
+        assert.equal(typeof data[0].coldt, "string");
+        result.closeSync();
+
+        common.dropTables(db, function () {
+          db.closeSync();
+        });
+      });
+    });
+  });
+});
@@ -0,0 +1,56 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database({ trimChar : true })
+  , assert = require("assert")
+  , values = ["a", "", "two words", "  lead", "exactly twenty chars", null]
+  ;
+
+db.openSync(common.connectionString);
+
+function check(rows) {
+  assert.equal(rows.length, values.length);
+  rows.forEach(function (row, i) {
+    var expected = values[i] === null ? null : values[i].replace(/ +$/, "");
+
+    assert.equal(row.colint, i);
+    assert.equal(row.colchar, expected);
+    // VARCHAR keeps its blanks
+    assert.equal(row.colvarchar, values[i] === null ? null : values[i] + "  ");
+  });
+}
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLCHAR CHAR(20), COLVARCHAR VARCHAR(40))");
+  values.forEach(function (value, i) {
+    db.querySync("insert into " + common.tableName + " values (?, ?, ?)",
+      [i, value, value === null ? null : value + "  "]);
+  });
+
+  var sql = "select colint, colchar, colvarchar from " + common.tableName + " order by colint";
+
+  db.query(sql, function (err, data) {
+    assert.equal(err, null);
+    check(data);
+
+    db.queryResult(sql, function (err, result) {
+      assert.equal(err, null);
+      assert.equal(result.trimChar, true);
+
+      // bound rowsets
+      result.fetchAll({ rowsetSize : 4 }, function (err, data) {
+        assert.equal(err, null);
+        check(data);
+        result.closeSync();
+
+        result = db.queryResultSync(sql);
+        result.trimChar = false;
+        assert.equal(result.fetchSync().colchar, "a" + new Array(20).join(" "));
+        result.closeSync();
+
+        common.dropTables(db, function () {
+          db.closeSync();
+        });
+      });
+    });
+  });
+});
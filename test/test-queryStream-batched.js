@@ -0,0 +1,51 @@
+var common = require("./common")
+  , odbc = require("../")
+  , db = new odbc.Database()
+  , assert = require("assert")
+  , Writable = require("stream").Writable
+  , rowCount = 200
+  ;
+
+db.openSync(common.connectionString);
+
+db.query("drop table " + common.tableName, function () {
+  db.querySync("create table " + common.tableName + " (COLINT INTEGER, COLTEXT VARCHAR(20))");
+
+  db.beginTransactionSync();
+  for (var i = 0; i < rowCount; i++) {
+    db.querySync("insert into " + common.tableName + " (colint, coltext) values (?, ?)", [i, "row " + i]);
+  }
+  db.commitTransactionSync();
+
+  var stream = db.queryStream({
+    sql : "select colint, coltext from " + common.tableName + " order by colint",
+    highWaterMark : 32
+  });
+  var seen = 0;
+
+  // a slow consumer: the stream must never buffer much more than a batch
+  var sink = new Writable({
+    objectMode : true,
+    highWaterMark : 1,
+    write : function (row, encoding, cb) {
+      assert.deepEqual(row, { colint : seen, coltext : "row " + seen });
+      assert.ok(stream._readableState.length <= 64);
+      seen++;
+      setImmediate(cb);
+    }
+  });
+
+  stream.on('error', function (err) {
+    throw err;
+  });
+
+  sink.on('finish', function () {
+    assert.equal(seen, rowCount);
+
+    common.dropTables(db, function () {
+      db.closeSync();
+    });
+  });
+
+  stream.pipe(sink);
+});